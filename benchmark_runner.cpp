@@ -5,6 +5,7 @@
 #include "dimacs.h"
 #include "solver.h"
 #include "solver_runner.h"
+#include "watch_search.h"
 
 bool ends_with(const std::string& string, const std::string& ending) {
     if (string.length() < ending.length())
@@ -22,30 +23,75 @@ bool ends_with(const std::string& string, const std::string& ending) {
 
 int main(int argc, char* argv[]) {
     if (argc < 3) {
-        std::cout << "Usage: SATSolverBenchmark [folder with .cnf files] [log-file]" << std::endl;
+        std::cout << "Usage: SATSolverBenchmark [folder with .cnf files] [log-file] [heuristic|watch-search|propagation|no-preprocess...]" << std::endl;
+        std::cout << "Heuristics: vsids, vmtf, lrb; all of them are compared if none is given" << std::endl;
+        std::cout << "Watch search kernels: auto, scalar, avx2; auto is used if none is given" << std::endl;
+        std::cout << "Propagation modes: auto, direct, prefetch; auto is used if none is given" << std::endl;
+        std::cout << "no-preprocess: the formulas go to the solver as they are, e.g. for the regression folder" << std::endl;
         return 1;
     }
 
     auto folder_name = argv[1];
     auto log_file = argv[2];
+    std::vector<heuristic_kind> heuristics;
+    std::vector<watch_search_mode> watch_searches;
+    std::vector<propagation_mode> propagations;
+    auto preprocess = true;
+    for (auto i = 3; i < argc; i++) {
+        heuristic_kind kind;
+        watch_search_mode mode;
+        propagation_mode propagation;
+        if (parse_heuristic(argv[i], kind)) {
+            heuristics.push_back(kind);
+        } else if (parse_watch_search(argv[i], mode)) {
+            watch_searches.push_back(mode);
+        } else if (parse_propagation(argv[i], propagation)) {
+            propagations.push_back(propagation);
+        } else if (std::string(argv[i]) == "no-preprocess") {
+            preprocess = false;
+        } else {
+            std::cout << "Unknown heuristic, watch search kernel or propagation mode: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    if (heuristics.empty())
+        heuristics = {heuristic_kind::VSIDS, heuristic_kind::VMTF, heuristic_kind::LRB};
+    if (watch_searches.empty())
+        watch_searches = {watch_search_mode::AUTO};
+    if (propagations.empty())
+        propagations = {propagation_mode::AUTO};
+
     std::ofstream fout(log_file);
     DIR* dir;
     dirent* ent;
     if ((dir = opendir(folder_name)) != nullptr) {
         while ((ent = readdir(dir)) != nullptr) {
-            std::string filename(ent->d_name, ent->d_namlen);
-            if (ends_with(filename, ".cnf")) {
-                fout << filename << "... \t";
-                size_t elapsed_time;
-                sat_result result;
-                measure_time(elapsed_time,
-                    solver_runner runner(folder_name + ("/" + filename));
-                    result = runner.solve(
-                        /*preprocess = */true,
-                        /*timeout = */std::chrono::seconds {1000}
-                    );
-                )
-                fout << (result == SAT ? "SAT" : (result == UNSAT ? "UNSAT" : "TIMEOUT")) << ", time: " << elapsed_time / 1000 << " seconds" << std::endl;
+            std::string filename(ent->d_name);
+            if (!ends_with(filename, ".cnf"))
+                continue;
+
+            for (auto heuristic: heuristics) {
+                for (auto watch_search: watch_searches) {
+                    for (auto propagation: propagations) {
+                        fout << filename << " [" << heuristic_name(heuristic) << ", "
+                             << watch_search::selected_name(watch_search) << ", "
+                             << propagation_name(propagation) << "]... \t";
+                        solver_options options;
+                        options.heuristic = heuristic;
+                        options.watch_search = watch_search;
+                        options.propagation = propagation;
+                        size_t elapsed_time;
+                        sat_result result;
+                        measure_time(elapsed_time,
+                            solver_runner runner(folder_name + ("/" + filename), options);
+                            result = runner.solve(
+                                preprocess,
+                                /*timeout = */std::chrono::seconds {1000}
+                            );
+                        )
+                        fout << (result == SAT ? "SAT" : (result == UNSAT ? "UNSAT" : "TIMEOUT")) << ", time: " << elapsed_time / 1000.0 << " seconds" << std::endl;
+                    }
+                }
             }
         }
         closedir(dir);
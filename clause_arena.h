@@ -0,0 +1,135 @@
+#ifndef SATSOLVER_CLAUSE_ARENA_H
+#define SATSOLVER_CLAUSE_ARENA_H
+
+#include "debug.h"
+#include "solver_types.h"
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+// Offset of a clause in the arena, measured in 32-bit words
+typedef uint32_t clause_ref;
+static constexpr clause_ref clause_ref_undef = UINT32_MAX;
+// The highest bit of a reference is left free, so it can be tagged together with a literal
+static constexpr clause_ref clause_ref_limit = 1u << 31;
+
+// Tiers of learnt clauses: core clauses are kept forever, tier2 clauses are kept while they are used
+// and local clauses are reduced by activity
+enum clause_tier : uint32_t {
+    CORE = 0,
+    TIER2 = 1,
+    LOCAL = 2
+};
+
+// Clause header, literals are stored right after it in the same arena
+struct clause {
+    uint32_t size;
+    uint32_t learnt : 1;
+    uint32_t removed : 1;
+    uint32_t tier : 2;
+    uint32_t lbd : 28;
+    float activity;
+    uint32_t used;
+    // position of the last replacement watch in a long clause, the next search resumes from it
+    uint32_t search_pos;
+
+    literal* begin() { return reinterpret_cast<literal*>(this + 1); }
+    literal* end() { return begin() + size; }
+    const literal* begin() const { return reinterpret_cast<const literal*>(this + 1); }
+    const literal* end() const { return begin() + size; }
+
+    literal& operator[](uint32_t i) { return begin()[i]; }
+    literal operator[](uint32_t i) const { return begin()[i]; }
+};
+
+static_assert(sizeof(clause) % sizeof(uint32_t) == 0, "Clause header must be word-aligned");
+static_assert(sizeof(literal) == sizeof(uint32_t), "Literals must occupy one arena word");
+
+class clause_arena {
+    std::vector<uint32_t> memory;
+    size_t wasted;
+
+    static constexpr size_t header_words = sizeof(clause) / sizeof(uint32_t);
+
+    static size_t clause_words(uint32_t size) {
+        return header_words + size;
+    }
+
+public:
+    clause_arena() : wasted(0) {}
+
+    template <typename Container>
+    clause_ref alloc(const Container& literals, bool learnt) {
+        auto size = (uint32_t) literals.size();
+        auto ref = memory.size();
+        if (ref + clause_words(size) >= clause_ref_limit)
+            throw std::length_error("Clause arena exceeds 31-bit offset range");
+
+        memory.resize(ref + clause_words(size));
+        auto& c = (*this)[(clause_ref) ref];
+        c.size = size;
+        c.learnt = learnt;
+        c.removed = false;
+        c.tier = LOCAL;
+        c.lbd = 0;
+        c.activity = 0;
+        c.used = 0;
+        c.search_pos = 2;
+        std::copy(literals.begin(), literals.end(), c.begin());
+        return (clause_ref) ref;
+    }
+
+    clause& operator[](clause_ref ref) {
+        return *reinterpret_cast<clause*>(memory.data() + ref);
+    }
+
+    const clause& operator[](clause_ref ref) const {
+        return *reinterpret_cast<const clause*>(memory.data() + ref);
+    }
+
+    void free(clause_ref ref) {
+        auto& c = (*this)[ref];
+        debug(if (c.removed)
+            debug_logic_error("Double free of clause: " << ref))
+
+        c.removed = true;
+        wasted += clause_words(c.size);
+    }
+
+    clause_ref end_ref() const {
+        return (clause_ref) memory.size();
+    }
+
+    size_t size_words() const {
+        return memory.size();
+    }
+
+    size_t wasted_words() const {
+        return wasted;
+    }
+
+    // Moves all live clauses starting from `from` down in place, preserving their order.
+    // `relocated(old_ref, new_ref)` is called for each live clause.
+    template <typename Callback>
+    void compact(clause_ref from, Callback relocated) {
+        auto read = (size_t) from;
+        auto write = (size_t) from;
+        while (read < memory.size()) {
+            const auto& c = *reinterpret_cast<const clause*>(memory.data() + read);
+            auto words = clause_words(c.size);
+            if (!c.removed) {
+                if (write != read)
+                    std::memmove(memory.data() + write, memory.data() + read, words * sizeof(uint32_t));
+                relocated((clause_ref) read, (clause_ref) write);
+                write += words;
+            } else {
+                wasted -= words;
+            }
+            read += words;
+        }
+        memory.resize(write);
+    }
+};
+
+#endif //SATSOLVER_CLAUSE_ARENA_H
@@ -4,6 +4,16 @@
 #define DEBUG
 //#define TRACE
 
+#include <sstream>
+#include <stdexcept>
+
+// also used by consistency checks that are enabled by the solver configuration rather than DEBUG
+#define debug_logic_error(x) {\
+    std::stringstream ss;\
+    ss << x;\
+    throw std::logic_error(ss.str());\
+}
+
 #ifdef DEBUG
 
 #include <iostream>
@@ -20,12 +30,6 @@
 
 #define info(x) { std::cout << "INFO\t" << x << std::endl; }
 
-#define debug_logic_error(x) {\
-    std::stringstream ss;\
-    ss << x;\
-    throw std::logic_error(ss.str());\
-}
-
 template<typename T>
 std::string trace_print_vector(const std::vector<T> vec, const std::string& separator = " ") {
     std::stringstream ss;
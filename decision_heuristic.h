@@ -0,0 +1,76 @@
+#ifndef SATSOLVER_DECISION_HEURISTIC_H
+#define SATSOLVER_DECISION_HEURISTIC_H
+
+#include "solver_options.h"
+#include "vsids_picker.h"
+#include "vmtf_picker.h"
+#include "lrb_picker.h"
+#include <variant>
+
+// Branching heuristic selected at construction time. Every engine provides the same hooks:
+// init, bump (variable took part in a conflict), on_conflict, on_var_assign, on_var_unset,
+// pick (best unassigned variable) and prefers (order of two variables)
+template <typename Solver>
+class decision_heuristic {
+    heuristic_kind kind;
+    std::variant<vsids_picker<Solver>, vmtf_picker<Solver>, lrb_picker<Solver>> picker;
+
+    // switch on the kind is cheaper than std::visit on the hot path
+    template <typename Function>
+    auto dispatch(Function&& function) {
+        switch (kind) {
+            case heuristic_kind::VMTF:
+                return function(*std::get_if<vmtf_picker<Solver>>(&picker));
+            case heuristic_kind::LRB:
+                return function(*std::get_if<lrb_picker<Solver>>(&picker));
+            default:
+                return function(*std::get_if<vsids_picker<Solver>>(&picker));
+        }
+    }
+
+public:
+    decision_heuristic(const Solver& solver, heuristic_kind kind)
+            : kind(kind), picker(std::in_place_type<vsids_picker<Solver>>, solver) {
+        // pickers refer to their own members, so they are constructed in place
+        switch (kind) {
+            case heuristic_kind::VMTF:
+                picker.template emplace<vmtf_picker<Solver>>(solver);
+                break;
+            case heuristic_kind::LRB:
+                picker.template emplace<lrb_picker<Solver>>(solver);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void init() {
+        dispatch([](auto& picker) { picker.init(); });
+    }
+
+    void bump(int var) {
+        dispatch([var](auto& picker) { picker.bump(var); });
+    }
+
+    void on_conflict() {
+        dispatch([](auto& picker) { picker.on_conflict(); });
+    }
+
+    void on_var_assign(int var) {
+        dispatch([var](auto& picker) { picker.on_var_assign(var); });
+    }
+
+    void on_var_unset(int var) {
+        dispatch([var](auto& picker) { picker.on_var_unset(var); });
+    }
+
+    int pick() {
+        return dispatch([](auto& picker) { return picker.pick(); });
+    }
+
+    bool prefers(int a, int b) {
+        return dispatch([a, b](auto& picker) { return picker.prefers(a, b); });
+    }
+};
+
+#endif //SATSOLVER_DECISION_HEURISTIC_H
@@ -0,0 +1,53 @@
+#ifndef SATSOLVER_FAST_RANDOM_H
+#define SATSOLVER_FAST_RANDOM_H
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+// xorshift64* generator, cheap enough to be used on every decision
+class fast_random {
+    uint64_t state;
+
+public:
+    explicit fast_random(uint64_t seed) {
+        this->seed(seed);
+    }
+
+    void seed(uint64_t seed) {
+        // state must never be zero
+        state = seed ^ 0x9e3779b97f4a7c15ull;
+        if (state == 0)
+            state = 1;
+    }
+
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545f4914f6cdd1dull;
+    }
+
+    // uniform in [0, bound)
+    uint64_t next_int(uint64_t bound) {
+        return (uint64_t) (((unsigned __int128) next() * bound) >> 64);
+    }
+
+    // uniform in [0, 1)
+    double next_double() {
+        return (next() >> 11) * (1.0 / (1ull << 53));
+    }
+
+    bool next_bool() {
+        return (next() >> 63) != 0;
+    }
+
+    template <typename T>
+    void shuffle(std::vector<T>& items) {
+        for (auto i = items.size(); i > 1; i--) {
+            std::swap(items[i - 1], items[next_int(i)]);
+        }
+    }
+};
+
+#endif //SATSOLVER_FAST_RANDOM_H
@@ -0,0 +1,272 @@
+#ifndef SATSOLVER_LOCAL_SEARCH_H
+#define SATSOLVER_LOCAL_SEARCH_H
+
+#include "debug.h"
+#include "solver_types.h"
+#include "fast_random.h"
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+// ProbSAT [10] over the clauses of the solver: long clauses are read in place from the clause arena,
+// binary clauses are collected from implication lists. Variables assigned on the root level are never flipped.
+template <typename Solver>
+class local_search {
+    // literals of a clause, long clauses point into the arena, which is not modified during the walk
+    struct walk_clause {
+        const literal* literals;
+        uint32_t size;
+    };
+
+    const Solver& solver;
+    std::vector<walk_clause> walk_clauses;
+    std::vector<literal> binary_literals;
+    // clauses containing a literal: occurrences[occurrence_start[lit]..occurrence_start[lit + 1])
+    std::vector<uint32_t> occurrence_start;
+    std::vector<uint32_t> occurrences;
+
+    // current assignment indexed by literal, and the number of true literals in each clause together with
+    // xor of their variables, so the only true variable of a clause is known without a scan
+    std::vector<value_state> values;
+    std::vector<uint32_t> true_count;
+    std::vector<uint32_t> true_vars;
+    // number of clauses that become unsatisfied if a variable is flipped
+    std::vector<uint32_t> break_count;
+    std::vector<uint32_t> unsat;
+    std::vector<uint32_t> unsat_position;
+    std::vector<bool> fixed;
+
+    // variables flipped since the best assignment was saved, replayed on it when a better one is found;
+    // if there are too many of them, the whole assignment is copied instead
+    std::vector<uint32_t> flips_since_best;
+    bool flips_overflow;
+    std::vector<value_state> best_values;
+    size_t best_unsat;
+    std::vector<double> break_weights;
+    std::vector<double> candidate_weights;
+
+public:
+    int64_t flips;
+    // clause literals and occurrences visited, in the same units as the ticks of the solver
+    int64_t ticks;
+    int64_t best_unsat_total;
+
+    local_search(const Solver& solver) : solver(solver), flips(0), ticks(0), best_unsat_total(0) {}
+
+    // Walks from the current assignment of the solver, unassigned variables start from their saved phases.
+    // Returns true if all clauses are satisfied, `phases` receives the best assignment found in any case.
+    bool run(fast_random& random, int64_t tick_budget, std::vector<value_state>& phases) {
+        build();
+        auto start_ticks = ticks;
+        best_unsat = unsat.size();
+        best_values = values;
+        flips_since_best.clear();
+        flips_overflow = false;
+
+        while (ticks - start_ticks < tick_budget && !unsat.empty()) {
+            auto var = pick_flip(random, unsat[random.next_int(unsat.size())]);
+            flip(var);
+            flips++;
+            if (flips_since_best.size() < solver.nb_vars / 4 + 16) {
+                flips_since_best.push_back(var);
+            } else {
+                flips_overflow = true;
+            }
+            if (unsat.size() < best_unsat) {
+                best_unsat = unsat.size();
+                save_best();
+            }
+        }
+
+        best_unsat_total += best_unsat;
+        for (auto var = 1; var <= solver.nb_vars; var++) {
+            phases[var] = best_values[make_literal(var, false)];
+        }
+        return best_unsat == 0;
+    }
+
+private:
+    static constexpr double cb = 2.38;
+    static constexpr double eps = 1.0;
+    static constexpr uint32_t max_break_weight = 64;
+
+    void build() {
+        auto nb_vars = solver.nb_vars;
+        values.assign(2 * (nb_vars + 1), UNDEF);
+        fixed.assign(nb_vars + 1, false);
+        for (auto var = 1; var <= nb_vars; var++) {
+            auto lit = make_literal(var, false);
+            auto value = solver.values[lit];
+            if (value != UNDEF) {
+                fixed[var] = solver.var_to_decision_level[var] == 0;
+            } else {
+                value = solver.saved_phases[var] == TRUE ? TRUE : FALSE;
+            }
+            values[lit] = value;
+            values[negate(lit)] = value == TRUE ? FALSE : TRUE;
+        }
+
+        // clauses satisfied on the root level can't be broken
+        walk_clauses.clear();
+        auto satisfied = [&](const literal* begin, const literal* end) {
+            for (auto it = begin; it != end; it++) {
+                if (fixed[var_of(*it)] && values[*it] == TRUE)
+                    return true;
+            }
+            return false;
+        };
+        for (auto cref: solver.original_clauses) {
+            const auto& c = solver.clauses[cref];
+            if (!c.removed && !satisfied(c.begin(), c.end()))
+                walk_clauses.push_back({c.begin(), c.size});
+        }
+        // binary literals are stored first, so the vector is not reallocated under the clause pointers
+        binary_literals.clear();
+        for (literal lit = 2; lit < solver.implications.size(); lit++) {
+            for (auto other: solver.implications[lit]) {
+                if (lit < other) {
+                    binary_literals.push_back(lit);
+                    binary_literals.push_back(other);
+                }
+            }
+        }
+        for (size_t i = 0; i < binary_literals.size(); i += 2) {
+            if (!satisfied(&binary_literals[i], &binary_literals[i] + 2))
+                walk_clauses.push_back({&binary_literals[i], 2});
+        }
+
+        occurrence_start.assign(2 * (nb_vars + 1) + 1, 0);
+        for (const auto& c: walk_clauses) {
+            for (uint32_t i = 0; i < c.size; i++) {
+                occurrence_start[c.literals[i] + 1]++;
+            }
+        }
+        for (size_t lit = 1; lit < occurrence_start.size(); lit++) {
+            occurrence_start[lit] += occurrence_start[lit - 1];
+        }
+        occurrences.resize(occurrence_start.back());
+        ticks += 2 * occurrences.size() / Solver::literals_per_tick;
+        auto fill = occurrence_start;
+        for (uint32_t index = 0; index < walk_clauses.size(); index++) {
+            const auto& c = walk_clauses[index];
+            for (uint32_t i = 0; i < c.size; i++) {
+                occurrences[fill[c.literals[i]]++] = index;
+            }
+        }
+
+        true_count.assign(walk_clauses.size(), 0);
+        true_vars.assign(walk_clauses.size(), 0);
+        break_count.assign(nb_vars + 1, 0);
+        unsat.clear();
+        unsat_position.assign(walk_clauses.size(), 0);
+        for (uint32_t index = 0; index < walk_clauses.size(); index++) {
+            const auto& c = walk_clauses[index];
+            for (uint32_t i = 0; i < c.size; i++) {
+                if (values[c.literals[i]] == TRUE) {
+                    true_count[index]++;
+                    true_vars[index] ^= var_of(c.literals[i]);
+                }
+            }
+            if (true_count[index] == 0) {
+                add_unsat(index);
+            } else if (true_count[index] == 1) {
+                break_count[true_vars[index]]++;
+            }
+        }
+
+        if (break_weights.empty()) {
+            for (uint32_t b = 0; b <= max_break_weight; b++) {
+                break_weights.push_back(std::pow(eps + b, -cb));
+            }
+        }
+    }
+
+    void add_unsat(uint32_t index) {
+        unsat_position[index] = unsat.size();
+        unsat.push_back(index);
+    }
+
+    void remove_unsat(uint32_t index) {
+        auto position = unsat_position[index];
+        auto moved = unsat.back();
+        unsat[position] = moved;
+        unsat_position[moved] = position;
+        unsat.pop_back();
+    }
+
+    // samples a variable of an unsatisfied clause with probability decreasing polynomially with its break count
+    uint32_t pick_flip(fast_random& random, uint32_t index) {
+        const auto& c = walk_clauses[index];
+        ticks++;
+        candidate_weights.clear();
+        auto total = 0.0;
+        for (uint32_t i = 0; i < c.size; i++) {
+            auto var = var_of(c.literals[i]);
+            auto weight = fixed[var] ? 0.0 : break_weights[std::min(break_count[var], max_break_weight)];
+            candidate_weights.push_back(weight);
+            total += weight;
+        }
+        debug(if (total == 0.0)
+            debug_logic_error("Unsatisfied clause has only fixed variables"))
+
+        auto threshold = random.next_double() * total;
+        for (uint32_t i = 0; i + 1 < c.size; i++) {
+            threshold -= candidate_weights[i];
+            if (threshold < 0 && candidate_weights[i] > 0)
+                return var_of(c.literals[i]);
+        }
+        for (auto i = c.size; i > 0; i--) {
+            if (candidate_weights[i - 1] > 0)
+                return var_of(c.literals[i - 1]);
+        }
+        return var_of(c.literals[c.size - 1]);
+    }
+
+    void flip(uint32_t var) {
+        auto true_lit = make_literal(var, values[make_literal(var, false)] == TRUE);
+        auto false_lit = negate(true_lit);
+        values[true_lit] = TRUE;
+        values[false_lit] = FALSE;
+        ticks += 1 + occurrence_start[true_lit + 1] - occurrence_start[true_lit]
+                 + occurrence_start[false_lit + 1] - occurrence_start[false_lit];
+
+        for (auto i = occurrence_start[true_lit]; i < occurrence_start[true_lit + 1]; i++) {
+            auto index = occurrences[i];
+            auto count = true_count[index]++;
+            if (count == 0) {
+                remove_unsat(index);
+                break_count[var]++;
+            } else if (count == 1) {
+                break_count[true_vars[index]]--;
+            }
+            true_vars[index] ^= var;
+        }
+        for (auto i = occurrence_start[false_lit]; i < occurrence_start[false_lit + 1]; i++) {
+            auto index = occurrences[i];
+            auto count = --true_count[index];
+            true_vars[index] ^= var;
+            if (count == 0) {
+                add_unsat(index);
+                break_count[var]--;
+            } else if (count == 1) {
+                break_count[true_vars[index]]++;
+            }
+        }
+    }
+
+    void save_best() {
+        if (flips_overflow) {
+            best_values = values;
+        } else {
+            for (auto var: flips_since_best) {
+                auto lit = make_literal(var, false);
+                best_values[lit] = values[lit];
+                best_values[negate(lit)] = values[negate(lit)];
+            }
+        }
+        flips_since_best.clear();
+        flips_overflow = false;
+    }
+};
+
+#endif //SATSOLVER_LOCAL_SEARCH_H
@@ -0,0 +1,94 @@
+#ifndef SATSOLVER_LRB_PICKER_H
+#define SATSOLVER_LRB_PICKER_H
+
+#include "debug.h"
+#include "solver_types.h"
+#include "min_heap.h"
+#include "vsids_picker.h"
+#include <vector>
+#include <cstdint>
+
+// Learning rate based branching [7]: score of a variable is an exponential moving average of
+// the share of conflicts it took part in while being assigned
+template <typename Solver>
+class lrb_picker {
+    const Solver& solver;
+    std::vector<double> lrb_score;
+    min_heap<int, score_compare> lrb_queue;
+    std::vector<int> vars_vector;
+    // conflict count at the moment of assignment and number of conflicts since then
+    std::vector<int64_t> assigned_at;
+    std::vector<int64_t> participated;
+    int64_t conflicts;
+    double step_size;
+
+public:
+    lrb_picker(const Solver& solver) : solver(solver), lrb_queue(score_compare(lrb_score)) {}
+
+    void init() {
+        conflicts = 0;
+        step_size = step_size_init;
+        lrb_score.assign(solver.nb_vars + 1, 0.0);
+        assigned_at.assign(solver.nb_vars + 1, 0);
+        participated.assign(solver.nb_vars + 1, 0);
+        vars_vector.clear();
+        vars_vector.reserve(solver.nb_vars);
+        for (auto var = 1; var <= solver.nb_vars; var++) {
+            vars_vector.push_back(var);
+        }
+        lrb_queue.rebuild_heap(vars_vector);
+    }
+
+    void bump(int var) {
+        participated[var]++;
+    }
+
+    void on_conflict() {
+        conflicts++;
+        if (step_size > step_size_min)
+            step_size -= step_size_dec;
+    }
+
+    void on_var_assign(int var) {
+        assigned_at[var] = conflicts;
+        participated[var] = 0;
+    }
+
+    void on_var_unset(int var) {
+        auto interval = conflicts - assigned_at[var];
+        if (interval > 0) {
+            auto reward = (double) participated[var] / interval;
+            lrb_score[var] = (1.0 - step_size) * lrb_score[var] + step_size * reward;
+        }
+
+        if (lrb_queue.in_heap(var)) {
+            lrb_queue.decrease(var);
+            lrb_queue.increase(var);
+        } else {
+            lrb_queue.insert(var);
+        }
+    }
+
+    // checks if the first variable would be picked before the second one
+    bool prefers(int a, int b) const {
+        if (lrb_score[a] != lrb_score[b])
+            return lrb_score[a] > lrb_score[b];
+        return a < b;
+    }
+
+    int pick() {
+        auto var = lrb_queue.min();
+        while (solver.values[make_literal(var, false)] != UNDEF) {
+            lrb_queue.extract_min();
+            var = lrb_queue.min();
+        }
+        return var;
+    }
+
+private:
+    static constexpr double step_size_init = 0.4;
+    static constexpr double step_size_min = 0.06;
+    static constexpr double step_size_dec = 1e-6;
+};
+
+#endif //SATSOLVER_LRB_PICKER_H
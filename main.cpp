@@ -5,10 +5,13 @@
 #include "solver_runner.h"
 #include <chrono>
 #include <iomanip>
+#include <cstring>
+#include <algorithm>
 
 #define SAT_RETURN_CODE 0
 #define UNSAT_RETURN_CODE 1
 #define WRONG_USAGE_RETURN_CODE 2
+#define UNKNOWN_RETURN_CODE 3
 
 #define benchmark(N, x) {\
     auto start = std::chrono::steady_clock::now();\
@@ -21,12 +24,57 @@
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cout << "Usage: SATSolver [dimacs-file]" << std::endl;
+        std::cout << "Usage: SATSolver [dimacs-file] [--restart=glucose|luby|none] [--heuristic=vsids|vmtf|lrb] [--watch-search=auto|scalar|avx2] [--propagation=prefetch|direct] [--chrono[=distance]] [--no-local-search] [--sequential-probing] [--ticks=limit] [--no-preprocess] [--elim-growth=clauses] [--bce] [--preprocess-threads=N] [--checks]" << std::endl;
         return WRONG_USAGE_RETURN_CODE;
     }
 
-    solver_runner runner(argv[1]);
-    auto result = runner.solve();
+    solver_options options;
+    auto preprocess = true;
+    for (auto i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--restart=glucose") == 0) {
+            options.restart = restart_policy::GLUCOSE;
+        } else if (strcmp(argv[i], "--restart=luby") == 0) {
+            options.restart = restart_policy::LUBY;
+        } else if (strcmp(argv[i], "--restart=none") == 0) {
+            options.restart = restart_policy::NONE;
+        } else if (strncmp(argv[i], "--heuristic=", 12) == 0 && parse_heuristic(argv[i] + 12, options.heuristic)) {
+            continue;
+        } else if (strcmp(argv[i], "--no-local-search") == 0) {
+            options.local_search = false;
+        } else if (strcmp(argv[i], "--sequential-probing") == 0) {
+            options.parallel_probing = false;
+        } else if (strcmp(argv[i], "--chrono") == 0) {
+            options.chrono_backtrack = true;
+        } else if (strncmp(argv[i], "--chrono=", 9) == 0) {
+            options.chrono_backtrack = true;
+            options.chrono_distance = atoi(argv[i] + 9);
+        } else if (strncmp(argv[i], "--propagation=", 14) == 0 && parse_propagation(argv[i] + 14, options.propagation)) {
+            continue;
+        } else if (strcmp(argv[i], "--checks") == 0) {
+            options.checks = true;
+        } else if (strcmp(argv[i], "--no-preprocess") == 0) {
+            preprocess = false;
+        } else if (strncmp(argv[i], "--elim-growth=", 14) == 0) {
+            options.elimination_growth = atoi(argv[i] + 14);
+        } else if (strcmp(argv[i], "--bce") == 0) {
+            options.blocked_clause_elimination = true;
+        } else if (strncmp(argv[i], "--preprocess-threads=", 21) == 0) {
+            options.preprocess_threads = std::max(1, atoi(argv[i] + 21));
+        } else if (strncmp(argv[i], "--ticks=", 8) == 0) {
+            options.tick_limit = atoll(argv[i] + 8);
+        } else if (strncmp(argv[i], "--watch-search=", 15) == 0 && parse_watch_search(argv[i] + 15, options.watch_search)) {
+            continue;
+        } else {
+            std::cout << "Unknown option: " << argv[i] << std::endl;
+            return WRONG_USAGE_RETURN_CODE;
+        }
+    }
+
+    solver_runner runner(argv[1], options);
+    auto result = runner.solve(preprocess);
+
+    if (result == UNKNOWN)
+        return UNKNOWN_RETURN_CODE;
 
-    return result ? SAT_RETURN_CODE : UNSAT_RETURN_CODE;
+    return result == SAT ? SAT_RETURN_CODE : UNSAT_RETURN_CODE;
 }
\ No newline at end of file
@@ -3,24 +3,28 @@
 
 #include "debug.h"
 #include <vector>
-#include <unordered_map>
+#include <algorithm>
 
-template <typename Key, typename Compare>
+// D-ary heap of small non-negative integer keys (variables), positions of keys are kept in a dense array
+template <typename Key, typename Compare, int D = 4>
 class min_heap {
     std::vector<Key> heap;
-    std::unordered_map<Key, int> indices;
+    // position of a key in the heap, -1 if the key is not in the heap
+    std::vector<int> indices;
     Compare comparator;
 
-    static int left_child(int i) { return 2 * i + 1; }
-    static int right_child(int i) { return 2 * i + 2; }
-    static int parent(int i) { return (i - 1) / 2; }
+    static int first_child(int i) { return D * i + 1; }
+    static int parent(int i) { return (i - 1) / D; }
 
     void sift_down(int i) {
         auto x = heap[i];
-        while (left_child(i) < heap.size()) {
-            auto j = left_child(i);
-            if (right_child(i) < heap.size() && comparator(heap[right_child(i)], heap[left_child(i)])) {
-                j = right_child(i);
+        auto size = (int) heap.size();
+        while (first_child(i) < size) {
+            auto j = first_child(i);
+            auto end = std::min(j + D, size);
+            for (auto k = j + 1; k < end; k++) {
+                if (comparator(heap[k], heap[j]))
+                    j = k;
             }
             if (comparator(x, heap[j]))
                 break;
@@ -35,29 +39,40 @@ class min_heap {
 
     void sift_up(int i) {
         auto x = heap[i];
-        auto p = parent(i);
-        while (i != 0 && comparator(x, heap[p])) {
+        while (i != 0) {
+            auto p = parent(i);
+            if (!comparator(x, heap[p]))
+                break;
+
             heap[i] = heap[p];
-            indices[heap[p]] = i;
+            indices[heap[i]] = i;
             i = p;
-            p = parent(p);
         }
         heap[i] = x;
         indices[x] = i;
     }
 
+    void reserve_key(const Key& key) {
+        if (key >= indices.size())
+            indices.resize(key + 1, -1);
+    }
+
 public:
     explicit min_heap(const Compare& comparator) : comparator(comparator) {}
 
-    void rebuild_heap(const std::vector<Key> container) {
-        heap = container;
-        indices.clear();
-        for (auto i = (int) heap.size() / 2; i >= 0; i--) {
-            sift_down(i);
+    void rebuild_heap(const std::vector<Key>& container) {
+        for (auto key: heap) {
+            indices[key] = -1;
         }
+        heap = container;
         for (auto i = 0; i < heap.size(); i++) {
+            reserve_key(heap[i]);
             indices[heap[i]] = i;
         }
+        for (auto i = (int) heap.size() / D; i >= 0; i--) {
+            if (i < heap.size())
+                sift_down(i);
+        }
     }
 
     size_t size() const {
@@ -65,7 +80,7 @@ public:
     }
 
     bool in_heap(const Key& key) const {
-        return indices.find(key) != indices.end();
+        return key < indices.size() && indices[key] >= 0;
     }
 
     void decrease(const Key& key) {
@@ -94,9 +109,9 @@ public:
             debug_logic_error("extract_min from empty heap"))
 
         auto key = heap[0];
-        heap[0] = heap[heap.size() - 1];
+        heap[0] = heap.back();
         indices[heap[0]] = 0;
-        indices.erase(key);
+        indices[key] = -1;
         heap.pop_back();
         if (heap.size() > 1)
             sift_down(0);
@@ -107,6 +122,7 @@ public:
         if (in_heap(key))
             debug_logic_error("Insert duplicate key: " << key)
 
+        reserve_key(key);
         indices[key] = heap.size();
         heap.push_back(key);
         sift_up(indices[key]);
@@ -117,17 +133,19 @@ public:
             debug_logic_error("Remove missing key: " << key)
 
         int key_index = indices[key];
-        indices.erase(key);
+        indices[key] = -1;
         if (key_index == heap.size() - 1) {
             heap.pop_back();
         } else {
-            heap[key_index] = heap[heap.size() - 1];
-            indices[heap[key_index]] = key_index;
+            auto moved = heap.back();
+            heap[key_index] = moved;
+            indices[moved] = key_index;
             heap.pop_back();
-            sift_down(key_index);
+            sift_up(key_index);
+            sift_down(indices[moved]);
         }
     }
 };
 
 
-#endif //SATSOLVER_MIN_HEAP_H
\ No newline at end of file
+#endif //SATSOLVER_MIN_HEAP_H
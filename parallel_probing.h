@@ -0,0 +1,207 @@
+#ifndef SATSOLVER_PARALLEL_PROBING_H
+#define SATSOLVER_PARALLEL_PROBING_H
+
+#include "debug.h"
+#include "solver_types.h"
+#include <vector>
+#include <cstdint>
+
+// Failed literal probing of up to 32 literals in both polarities at once: every literal holds a 64-bit mask
+// of lanes in which it is implied, lane 2i assumes the i-th probe, lane 2i+1 its negation. Binary and long clauses
+// propagate all lanes in one pass, a lane fails when some literal is implied in it together with its negation.
+// Works on the root level of the solver, whose values are shared by all lanes.
+template <typename Solver>
+class parallel_probing {
+    const Solver& solver;
+    // long clauses containing a literal: occurrences[occurrence_start[lit]..occurrence_start[lit + 1])
+    std::vector<uint32_t> occurrence_start;
+    std::vector<clause_ref> occurrences;
+
+    std::vector<uint64_t> lanes;
+    std::vector<literal> touched;
+    std::vector<literal> queue;
+    std::vector<bool> queued;
+    std::vector<uint64_t> prefix;
+    uint64_t active;
+    uint64_t failed;
+
+    static constexpr uint64_t even_lanes = 0x5555555555555555ull;
+
+public:
+    static constexpr uint32_t max_probes = 32;
+
+    int64_t ticks;
+    // results of the last batch: units, failed probes among them, and pairs (probe, literal) of equivalent literals
+    std::vector<literal> units;
+    uint32_t failed_count;
+    std::vector<std::pair<literal, literal>> equivalences;
+
+    parallel_probing(const Solver& solver) : solver(solver), ticks(0), failed_count(0) {}
+
+    // Collects occurrences of all live long clauses, they must not change until the next call
+    void build() {
+        auto literal_count = 2 * (solver.nb_vars + 1);
+        lanes.assign(literal_count, 0);
+        queued.assign(literal_count, false);
+        occurrence_start.assign(literal_count + 1, 0);
+        auto for_each_clause = [this](auto callback) {
+            for (const auto* refs: {&solver.original_clauses, &solver.learnt_clauses}) {
+                for (auto cref: *refs) {
+                    if (!solver.clauses[cref].removed)
+                        callback(cref, solver.clauses[cref]);
+                }
+            }
+        };
+        for_each_clause([this](clause_ref, const clause& c) {
+            for (auto lit: c) {
+                occurrence_start[lit + 1]++;
+            }
+        });
+        for (size_t lit = 1; lit < occurrence_start.size(); lit++) {
+            occurrence_start[lit] += occurrence_start[lit - 1];
+        }
+        occurrences.resize(occurrence_start.back());
+        auto fill = occurrence_start;
+        for_each_clause([&](clause_ref cref, const clause& c) {
+            for (auto lit: c) {
+                occurrences[fill[lit]++] = cref;
+            }
+        });
+        ticks += 2 * occurrences.size() / Solver::literals_per_tick;
+    }
+
+    // Probes unassigned literals of different variables, at most max_probes of them
+    void probe(const std::vector<literal>& probes) {
+        debug(if (probes.size() > max_probes)
+            debug_logic_error("Too many literals for parallel probing: " << probes.size()))
+
+        active = probes.size() == max_probes ? ~0ull : (1ull << (2 * probes.size())) - 1;
+        failed = 0;
+        for (uint32_t i = 0; i < probes.size(); i++) {
+            assign(probes[i], 1ull << (2 * i));
+            assign(negate(probes[i]), 1ull << (2 * i + 1));
+        }
+        for (size_t head = 0; head < queue.size() && active != 0; head++) {
+            auto lit = queue[head];
+            queued[lit] = false;
+            propagate(lit);
+        }
+        collect_results(probes);
+
+        for (auto lit: touched) {
+            lanes[lit] = 0;
+        }
+        for (auto lit: queue) {
+            queued[lit] = false;
+        }
+        touched.clear();
+        queue.clear();
+    }
+
+private:
+    void fail(uint64_t mask) {
+        failed |= mask & active;
+        active &= ~mask;
+    }
+
+    void assign(literal lit, uint64_t mask) {
+        mask &= active;
+        auto value = solver.values[lit];
+        if (mask == 0 || value == TRUE)
+            return;
+
+        if (value == FALSE) {
+            fail(mask);
+            return;
+        }
+        auto added = mask & ~lanes[lit];
+        if (added == 0)
+            return;
+
+        if (lanes[lit] == 0)
+            touched.push_back(lit);
+        lanes[lit] |= added;
+        if (lanes[lit] & lanes[negate(lit)])
+            fail(lanes[lit] & lanes[negate(lit)]);
+        if (!queued[lit]) {
+            queued[lit] = true;
+            queue.push_back(lit);
+        }
+    }
+
+    // lanes in which the literal is false, all of them for a literal that is false on the root level
+    uint64_t false_lanes(literal lit) {
+        auto value = solver.values[lit];
+        if (value == FALSE)
+            return ~0ull;
+
+        return value == TRUE ? 0 : lanes[negate(lit)];
+    }
+
+    void propagate(literal lit) {
+        auto mask = lanes[lit] & active;
+        if (mask == 0)
+            return;
+
+        auto false_lit = negate(lit);
+        ticks++;
+        for (auto implied: solver.implications[false_lit]) {
+            assign(implied, mask);
+        }
+        for (auto i = occurrence_start[false_lit]; i < occurrence_start[false_lit + 1] && active != 0; i++) {
+            propagate_clause(solver.clauses[occurrences[i]]);
+        }
+    }
+
+    // a literal is implied in the lanes where all other literals of the clause are false
+    void propagate_clause(const clause& c) {
+        ticks += 1 + c.size / Solver::literals_per_tick;
+        prefix.resize(c.size + 1);
+        prefix[0] = ~0ull;
+        for (uint32_t i = 0; i < c.size; i++) {
+            prefix[i + 1] = prefix[i] & false_lanes(c[i]);
+        }
+        uint64_t suffix = ~0ull;
+        for (auto i = c.size; i > 0; i--) {
+            auto others = prefix[i - 1] & suffix & active;
+            if (others != 0)
+                assign(c[i - 1], others);
+            suffix &= false_lanes(c[i - 1]);
+            if (suffix == 0)
+                break;
+        }
+    }
+
+    // failed lanes give units, a literal implied in both lanes of a probe is a unit, a literal implied with
+    // the value of the probe in both lanes is equivalent to it
+    void collect_results(const std::vector<literal>& probes) {
+        units.clear();
+        equivalences.clear();
+        failed_count = 0;
+        for (uint32_t i = 0; i < probes.size(); i++) {
+            for (auto side: {0, 1}) {
+                if (failed & (1ull << (2 * i + side))) {
+                    units.push_back(side == 0 ? negate(probes[i]) : probes[i]);
+                    failed_count++;
+                }
+            }
+        }
+
+        auto pairs = active & (active >> 1) & even_lanes;
+        for (auto lit: touched) {
+            auto both = lanes[lit] & (lanes[lit] >> 1) & pairs;
+            if (both != 0)
+                units.push_back(lit);
+
+            auto equal = lanes[lit] & (lanes[negate(lit)] >> 1) & pairs;
+            while (equal != 0) {
+                auto probe_lit = probes[__builtin_ctzll(equal) / 2];
+                equal &= equal - 1;
+                if (var_of(probe_lit) != var_of(lit))
+                    equivalences.emplace_back(probe_lit, lit);
+            }
+        }
+    }
+};
+
+#endif //SATSOLVER_PARALLEL_PROBING_H
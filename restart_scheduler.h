@@ -0,0 +1,103 @@
+#ifndef SATSOLVER_RESTART_SCHEDULER_H
+#define SATSOLVER_RESTART_SCHEDULER_H
+
+#include "solver_options.h"
+#include <cstdint>
+#include <algorithm>
+
+// Exponential moving average, which is a plain average until enough values are collected
+class moving_average {
+    double value;
+    double alpha;
+    int64_t count;
+
+public:
+    explicit moving_average(double alpha) : value(0.0), alpha(alpha), count(0) {}
+
+    void init() {
+        value = 0.0;
+        count = 0;
+    }
+
+    void update(double x) {
+        count++;
+        value += (x - value) * std::max(alpha, 1.0 / count);
+    }
+
+    double get() const {
+        return value;
+    }
+};
+
+// Decides when the search should restart:
+// LUBY restarts after luby(i) * unit conflicts,
+// GLUCOSE restarts when LBD of recent learnt clauses is much worse than the overall average [3]
+class restart_scheduler {
+    solver_options options;
+    int64_t conflicts_since_restart;
+    int64_t luby_index;
+    int64_t luby_limit;
+    moving_average fast_lbd;
+    moving_average slow_lbd;
+
+public:
+    explicit restart_scheduler(const solver_options& options)
+            : options(options), fast_lbd(fast_lbd_alpha), slow_lbd(slow_lbd_alpha) {}
+
+    void init() {
+        conflicts_since_restart = 0;
+        luby_index = 0;
+        luby_limit = luby(luby_index) * options.luby_unit;
+        fast_lbd.init();
+        slow_lbd.init();
+    }
+
+    void on_conflict(uint32_t lbd) {
+        conflicts_since_restart++;
+        fast_lbd.update(lbd);
+        slow_lbd.update(lbd);
+    }
+
+    bool should_restart() const {
+        switch (options.restart) {
+            case restart_policy::NONE:
+                return false;
+            case restart_policy::LUBY:
+                return conflicts_since_restart >= luby_limit;
+            case restart_policy::GLUCOSE:
+                return conflicts_since_restart >= glucose_min_conflicts
+                       && fast_lbd.get() * glucose_margin > slow_lbd.get();
+        }
+        return false;
+    }
+
+    void on_restart() {
+        conflicts_since_restart = 0;
+        luby_index++;
+        luby_limit = luby(luby_index) * options.luby_unit;
+    }
+
+private:
+    // i-th element of the Luby sequence: 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ...
+    static int64_t luby(int64_t i) {
+        int64_t size = 1;
+        int64_t power = 1;
+        while (size < i + 1) {
+            size = 2 * size + 1;
+            power *= 2;
+        }
+        while (size - 1 != i) {
+            size = (size - 1) / 2;
+            power /= 2;
+            i %= size;
+        }
+        return power;
+    }
+
+    static constexpr double fast_lbd_alpha = 1.0 / 32;
+    static constexpr double slow_lbd_alpha = 1.0 / 4096;
+    static constexpr double glucose_margin = 0.8;
+    static constexpr int64_t glucose_min_conflicts = 50;
+};
+
+#endif //SATSOLVER_RESTART_SCHEDULER_H
@@ -1,5 +1,5 @@
 #include <algorithm>
-#include <unordered_map>
+#include <functional>
 #include <unordered_set>
 #include <chrono>
 #include <iomanip>
@@ -7,17 +7,32 @@
 #include "sat_utils.h"
 #include "debug.h"
 
-sat_preprocessor::sat_preprocessor(const dimacs &formula) :
+sat_preprocessor::sat_preprocessor(const dimacs &formula, int32_t elimination_growth,
+                                   bool blocked_clause_elimination, uint32_t threads) :
         nb_vars(formula.nb_vars),
-        clauses(formula.clauses),
+        elimination_queue(elimination_compare(elimination_cost)),
+        blocking_queue(elimination_compare(blocking_cost)),
+        blocked_clause_rounds(blocked_clause_elimination),
+        elimination_growth(elimination_growth),
+        pool(threads),
         remapper(nb_vars),
+        ticks(0),
         propagated(0),
-        niver_eliminated(0),
+        variables_eliminated(0),
+        clauses_blocked(0),
+        clauses_subsumed(0),
+        clauses_strengthened(0),
         hyp_bin_res_resolved(0),
         equality_eliminated(0) {
     prior_values.resize(nb_vars + 1);
     std::fill(prior_values.begin(), prior_values.end(), preprocessor_value_state::UNDEF);
     unsat = false;
+    implication_start.resize(2 * (nb_vars + 1) + 1);
+
+    clauses.reserve(formula.clauses.size());
+    for (const auto& signed_clause: formula.clauses) {
+        clauses.push_back(to_literals(signed_clause));
+    }
 }
 
 std::pair<dimacs, sat_remapper> sat_preprocessor::preprocess() {
@@ -27,19 +42,21 @@ std::pair<dimacs, sat_remapper> sat_preprocessor::preprocess() {
     info("nb_vars = " << nb_vars << ", nb_clauses = " << clauses.size());
     auto changed = true;
     // TODO inprocessing
-    while (changed && !is_interrupted()) {
+    while (changed && !is_interrupted() && !is_timed_out()) {
         changed = false;
         changed |= propagate_all();
-        changed |= niver();
+        changed |= eliminate_blocked_clauses();
+        changed |= eliminate_variables();
         changed |= hyper_binary_resolution();
         changed |= eliminate_equality();
+        changed |= subsume_clauses();
 
-        filter_implication_graph();
+        rebuild_implication_graph();
         debug(
-            std::unordered_set<int> vars;
+            std::unordered_set<uint32_t> vars;
             for (const auto& clause: clauses) {
-                for (int signed_var: clause) {
-                    vars.insert(abs(signed_var));
+                for (auto lit: clause) {
+                    vars.insert(var_of(lit));
                 }
             }
             info("nb_vars = " << vars.size() << ", nb_clauses = " << clauses.size())
@@ -74,57 +91,89 @@ std::pair<dimacs, sat_remapper> sat_preprocessor::preprocess() {
                 break;
         }
     }
-    for (auto& clause: clauses) {
-        for (int& signed_var: clause) {
-            auto sign = signed_var > 0 ? 1 : -1;
-            auto var = abs(signed_var);
+    new_formula.clauses.reserve(clauses.size());
+    for (const auto& clause: clauses) {
+        std::vector<int> new_clause;
+        new_clause.reserve(clause.size());
+        for (auto lit: clause) {
+            auto var = var_of(lit);
             debug(if (remapper.get_prior(var) != preprocessor_value_state::UNDEF)
                 debug_logic_error("Prior value is still in preprocessed clause: " << var << ", value: " << (int) remapper.get_prior(var)))
 
-            signed_var = sign * remapper.get_mapped_variable(var);
+            auto new_var = remapper.get_mapped_variable(var);
+            new_clause.push_back(is_negative(lit) ? -new_var : new_var);
         }
+        new_formula.clauses.push_back(std::move(new_clause));
     }
     new_formula.nb_vars = new_nb_vars;
-    new_formula.clauses = clauses;
     new_formula.nb_clauses = (uint32_t) new_formula.clauses.size();
     info("Preprocessor: nb_vars: " << nb_vars << " -> " << new_nb_vars)
     info("Preprocessor: nb_clauses: " << old_nb_clauses << " -> " << new_formula.nb_clauses)
     info("Preprocessor: variables propagated: " << propagated << ", " <<
          hyp_bin_res_resolved << " of them resolved with hyp_bin_res")
-    info("Preprocessor: NiVER eliminated: " << niver_eliminated)
+    info("Preprocessor: BVE eliminated: " << variables_eliminated)
+    info("Preprocessor: blocked clauses eliminated: " << clauses_blocked)
+    info("Preprocessor: subsumed clauses: " << clauses_subsumed << ", strengthened: " << clauses_strengthened)
     info("Preprocessor: eliminated with equality: " << equality_eliminated)
+    info("Preprocessor: ticks: " << ticks)
     auto duration = std::chrono::steady_clock::now() - start_time;
     info("Preprocessor: Elapsed time: " << std::fixed << std::setprecision(1)
          << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() / 1000.0 << " seconds")
     return std::make_pair(new_formula, remapper);
 }
 
-void sat_preprocessor::filter_implication_graph() {
-    for (auto var = 1; var <= nb_vars; var++) {
-        if (prior_values[var] != preprocessor_value_state::UNDEF) {
-            implication_graph[var].clear();
-            implication_graph[-var].clear();
-        }
-    }
-    for (auto& [_, set]: implication_graph) {
-        for (auto iter = set.begin(), last = set.end(); iter != last;) {
-            if (prior_values[abs(*iter)] != preprocessor_value_state::UNDEF) {
-                iter = set.erase(iter);
+// Merges the pending edges into the rows and drops the edges of assigned and eliminated variables
+void sat_preprocessor::rebuild_implication_graph() {
+    auto assigned = [this](literal lit) {
+        return prior_values[var_of(lit)] != preprocessor_value_state::UNDEF;
+    };
+    pending_edges.erase(
+            std::remove_if(pending_edges.begin(), pending_edges.end(), [&assigned](const auto& edge) {
+                return assigned(edge.first) || assigned(edge.second);
+            }),
+            pending_edges.end()
+    );
+    std::sort(pending_edges.begin(), pending_edges.end());
+    ticks += implication_targets.size() + pending_edges.size();
+
+    std::vector<uint32_t> new_start(implication_start.size());
+    std::vector<literal> new_targets;
+    new_targets.reserve(implication_targets.size() + pending_edges.size());
+    auto edge = pending_edges.begin();
+    for (literal from = 0; from + 1 < implication_start.size(); from++) {
+        new_start[from] = new_targets.size();
+        if (assigned(from))
+            continue;
+
+        // both sequences are sorted, duplicates are adjacent in the merged one
+        auto old_it = implication_targets.begin() + implication_start[from];
+        auto old_end = implication_targets.begin() + implication_start[from + 1];
+        while (old_it != old_end || (edge != pending_edges.end() && edge->first == from)) {
+            literal to;
+            if (edge == pending_edges.end() || edge->first != from || (old_it != old_end && *old_it <= edge->second)) {
+                to = *old_it++;
             } else {
-                ++iter;
+                to = (edge++)->second;
             }
+            if (!assigned(to) && (new_targets.size() == new_start[from] || new_targets.back() != to))
+                new_targets.push_back(to);
         }
     }
+    new_start.back() = new_targets.size();
+    implication_start = std::move(new_start);
+    implication_targets = std::move(new_targets);
+    pending_edges.clear();
 }
 
-void sat_preprocessor::add_implication_edge(int from, int to) {
-    implication_graph[from].insert(to);
-};
+// Visible to the other methods after the next rebuild
+void sat_preprocessor::add_implication_edge(literal from, literal to) {
+    pending_edges.emplace_back(from, to);
+}
 
-bool sat_preprocessor::has_implication_edge(int from, int to) {
-    const auto& set = implication_graph[from];
-    return set.find(to) != set.end();
-};
+bool sat_preprocessor::has_implication_edge(literal from, literal to) const {
+    return std::binary_search(implication_targets.begin() + implication_start[from],
+                              implication_targets.begin() + implication_start[from + 1], to);
+}
 
 bool sat_preprocessor::hyper_binary_resolution() {
     if (is_interrupted())
@@ -132,130 +181,149 @@ bool sat_preprocessor::hyper_binary_resolution() {
 
     info("Started HypBinRes...")
     bool changed = false;
-    auto local_start = std::chrono::steady_clock::now();
-    std::unordered_set<int> unit_literals;
+    auto start_ticks = ticks;
+    std::vector<bool> unit_literals(implication_start.size() - 1);
 
     for (const auto& clause: clauses) {
+        ticks++;
         if (clause.size() == 2) {
-            add_implication_edge(-clause[0], clause[1]);
-            add_implication_edge(-clause[1], clause[0]);
+            add_implication_edge(negate(clause[0]), clause[1]);
+            add_implication_edge(negate(clause[1]), clause[0]);
         }
         if (clause.size() == 1) {
-            unit_literals.insert(clause[0]);
+            unit_literals[clause[0]] = true;
         }
     }
+    rebuild_implication_graph();
 
-    for (auto clause_id = 0; clause_id < clauses.size(); clause_id++) {
-        if (is_interrupted_hyp_bin_res(local_start))
-            break;
-
-        auto clause = clauses[clause_id];
-        std::unordered_map<int, int> literal_count {};
-        for (int signed_var: clause) {
-            for (int implied_literal: implication_graph[signed_var]) {
-                if (prior_values[abs(implied_literal)] != preprocessor_value_state::UNDEF)
-                    continue;
+    // blocks of a wave are resolved against the same graph on the threads of the pool, their edges and units
+    // are merged in the order of blocks; a single thread resolves one clause at a time
+    auto block_count = pool.size();
+    auto block_size = block_count == 1 ? 1 : hyp_bin_res_block_size;
+    std::vector<hyp_bin_res_block> blocks(block_count);
+    for (auto& block: blocks) {
+        block.literal_count.resize(implication_start.size() - 1);
+    }
+    size_t wave_start = 0;
+    while (wave_start < clauses.size() && !is_interrupted_hyp_bin_res(start_ticks)) {
+        if (pending_edges.size() >= implication_targets.size() / 4 + min_rebuild_edges)
+            rebuild_implication_graph();
 
-                literal_count[implied_literal]++;
+        auto wave_end = std::min(clauses.size(), wave_start + block_count * block_size);
+        pool.run(block_count, [&](uint32_t block_index) {
+            auto begin = std::min(wave_end, wave_start + block_index * block_size);
+            auto end = std::min(wave_end, begin + block_size);
+            for (auto clause_id = begin; clause_id < end; clause_id++) {
+                hyper_binary_resolve(clauses[clause_id], blocks[block_index]);
             }
-        }
-        for (auto [literal, count]: literal_count) {
-            if (count < clause.size() - 1)
-                continue;
+        });
+        wave_start = wave_end;
 
-            auto failed = false;
-            auto missed_literal = 0;
-            for (int signed_var: clause) {
-                if (!has_implication_edge(signed_var, literal)) {
-                    if (missed_literal != 0) {
-                        failed = true;
-                        break;
-                    }
-                    missed_literal = signed_var;
-                }
+        for (auto& block: blocks) {
+            ticks += block.ticks;
+            block.ticks = 0;
+            for (auto [from, to]: block.edges) {
+                add_implication_edge(from, to);
             }
-            if (failed)
-                continue;
-
-            if (missed_literal == 0 || missed_literal == literal) {
-                if (unit_literals.find(literal) == unit_literals.end()) {
-                    clauses.push_back({literal});
-                    unit_literals.insert(literal);
+            block.edges.clear();
+            for (auto unit: block.units) {
+                if (!unit_literals[unit]) {
+                    clauses.push_back({unit});
+                    unit_literals[unit] = true;
                     hyp_bin_res_resolved++;
                     changed = true;
                 }
-                continue;
             }
-
-            // tautology
-            if (missed_literal == -literal)
-                continue;
-
-            if (has_implication_edge(-missed_literal, literal))
-                continue;
-
-            add_implication_edge(-missed_literal, literal);
-            add_implication_edge(-literal, missed_literal);
+            block.units.clear();
         }
     }
+    rebuild_implication_graph();
 
     return changed;
 }
 
-bool sat_preprocessor::eliminate_equality() {
-    if (is_interrupted())
-        return false;
-
-    info("Started equality elimination...")
-    auto changed = false;
-    std::vector<int> equality;
-    equality.resize(nb_vars + 1);
+// Collects the literals implied by all literals of the clause but one, which give new edges,
+// or by all of them, which give units
+void sat_preprocessor::hyper_binary_resolve(const std::vector<literal>& clause, hyp_bin_res_block& block) const {
+    auto& literal_count = block.literal_count;
+    block.counted.clear();
+    for (auto lit: clause) {
+        auto begin = implication_start[lit];
+        auto end = implication_start[lit + 1];
+        block.ticks += 1 + end - begin;
+        // the rows contain only unassigned literals
+        for (auto i = begin; i < end; i++) {
+            auto implied_literal = implication_targets[i];
+            if (literal_count[implied_literal]++ == 0)
+                block.counted.push_back(implied_literal);
+        }
+    }
+    for (auto implied_literal: block.counted) {
+        auto count = literal_count[implied_literal];
+        literal_count[implied_literal] = 0;
+        if (count < clause.size() - 1)
+            continue;
 
-    auto set_equal = [&equality](int signed_from, int signed_to) {
-        if (abs(signed_to) < abs(signed_from))
-            std::swap(signed_from, signed_to);
+        block.ticks += clause.size();
+        // literal 0 belongs to the unused variable 0 and means "no literal"
+        auto failed = false;
+        literal missed_literal = 0;
+        for (auto lit: clause) {
+            if (!has_implication_edge(lit, implied_literal)) {
+                if (missed_literal != 0) {
+                    failed = true;
+                    break;
+                }
+                missed_literal = lit;
+            }
+        }
+        if (failed)
+            continue;
 
-        auto from = abs(signed_from);
-        auto sign = signed_from > 0 ? 1 : -1;
-        equality[from] = signed_to * sign;
-    };
-    auto get_equal = [&equality](int signed_from) -> int {
-        auto from = abs(signed_from);
-        auto sign = signed_from > 0 ? 1 : -1;
-        return equality[from] * sign;
-    };
+        if (missed_literal == 0 || missed_literal == implied_literal) {
+            block.units.push_back(implied_literal);
+            continue;
+        }
 
-    for (const auto& [from, set]: implication_graph) {
-        if (prior_values[abs(from)] != preprocessor_value_state::UNDEF)
+        // tautology
+        if (missed_literal == negate(implied_literal))
             continue;
 
-        for (auto to: set) {
-            if (prior_values[abs(to)] != preprocessor_value_state::UNDEF)
-                continue;
+        if (has_implication_edge(negate(missed_literal), implied_literal))
+            continue;
 
-            if (has_implication_edge(to, from)) {
-                set_equal(from, to);
-            }
-        }
+        block.edges.emplace_back(negate(missed_literal), implied_literal);
+        block.edges.emplace_back(negate(implied_literal), missed_literal);
     }
+}
 
-    for (auto var = 1; var <= nb_vars; var++) {
-        auto eq_var = get_equal(var);
-        while (get_equal(eq_var) != 0) {
-            eq_var = get_equal(eq_var);
-        }
-        if (eq_var != 0) {
-            set_equal(var, eq_var);
-        }
+bool sat_preprocessor::eliminate_equality() {
+    if (is_interrupted())
+        return false;
+
+    info("Started equality elimination...")
+    auto changed = false;
+    equal_parent.resize(nb_vars + 1);
+    for (auto var = 0; var <= nb_vars; var++) {
+        equal_parent[var] = make_literal(var, false);
     }
+    unite_strongly_connected();
+    if (unsat)
+        return false;
+
+    auto get_equal = [this](literal from) -> literal {
+        auto to = find_equal(from);
+        return to == from ? 0 : to;
+    };
 
     for (auto& clause: clauses) {
-        for (int& signed_var: clause) {
-            auto eq_var = get_equal(signed_var);
-            if (eq_var == 0)
+        ticks += clause.size();
+        for (auto& lit: clause) {
+            auto eq_literal = get_equal(lit);
+            if (eq_literal == 0)
                 continue;
 
-            signed_var = eq_var;
+            lit = eq_literal;
             changed = true;
         }
         std::sort(clause.begin(), clause.end());
@@ -268,142 +336,560 @@ bool sat_preprocessor::eliminate_equality() {
         }
     }
     clauses.erase(
-            std::remove_if(clauses.begin(), clauses.end(), sat_utils::is_invalidated),
+            std::remove_if(clauses.begin(), clauses.end(), [](const auto& clause) {
+                return sat_utils::is_invalidated(clause);
+            }),
             clauses.end()
     );
 
     for (auto var = 1; var <= nb_vars; var++) {
-        auto eq_var = get_equal(var);
-        if (eq_var == 0)
+        auto eq_literal = get_equal(make_literal(var, false));
+        if (eq_literal == 0)
             continue;
 
         prior_values[var] = preprocessor_value_state::EQ;
-        remapper.add_eq_var(var, eq_var);
+        remapper.add_eq_var(var, to_signed(eq_literal));
         equality_eliminated++;
     }
 
     return changed;
 }
 
-std::vector<int> sat_preprocessor::resolve(int var, const std::vector<int>& clause1, const std::vector<int>& clause2) {
-    std::vector<int> result;
+// Literals of a strongly connected component of the implication graph are equal, they are found with
+// an iterative Tarjan's algorithm. A literal and its negation in one component make the formula UNSAT.
+void sat_preprocessor::unite_strongly_connected() {
+    auto literal_count = implication_start.size() - 1;
+    // discovery order starting from 1, 0 for unvisited literals
+    std::vector<uint32_t> index(literal_count);
+    std::vector<uint32_t> low_link(literal_count);
+    std::vector<bool> on_stack(literal_count);
+    std::vector<literal> component_stack;
+    // depth-first search path: literal and the position of its next implication
+    std::vector<std::pair<literal, uint32_t>> path;
+    uint32_t next_index = 1;
+
+    auto visit = [&](literal lit) {
+        index[lit] = low_link[lit] = next_index++;
+        on_stack[lit] = true;
+        component_stack.push_back(lit);
+        path.emplace_back(lit, implication_start[lit]);
+    };
+    for (literal root = 0; root < literal_count && !unsat; root++) {
+        if (index[root] != 0 || prior_values[var_of(root)] != preprocessor_value_state::UNDEF)
+            continue;
+
+        visit(root);
+        while (!path.empty()) {
+            auto [lit, position] = path.back();
+            if (position < implication_start[lit + 1]) {
+                path.back().second++;
+                ticks++;
+                auto implied_literal = implication_targets[position];
+                if (prior_values[var_of(implied_literal)] != preprocessor_value_state::UNDEF)
+                    continue;
+
+                if (index[implied_literal] == 0) {
+                    visit(implied_literal);
+                } else if (on_stack[implied_literal]) {
+                    low_link[lit] = std::min(low_link[lit], index[implied_literal]);
+                }
+                continue;
+            }
+
+            path.pop_back();
+            if (!path.empty()) {
+                auto parent = path.back().first;
+                low_link[parent] = std::min(low_link[parent], low_link[lit]);
+            }
+            if (low_link[lit] != index[lit])
+                continue;
+
+            literal member;
+            do {
+                member = component_stack.back();
+                component_stack.pop_back();
+                on_stack[member] = false;
+                unite_equal(member, lit);
+            } while (member != lit);
+        }
+    }
+}
+
+// The root of a class is its literal with the smallest variable, so a literal and its negation
+// have negated roots
+void sat_preprocessor::unite_equal(literal lit1, literal lit2) {
+    auto root1 = find_equal(lit1);
+    auto root2 = find_equal(lit2);
+    if (var_of(root1) == var_of(root2)) {
+        unsat |= root1 != root2;
+        return;
+    }
+
+    if (var_of(root1) < var_of(root2))
+        std::swap(root1, root2);
+    equal_parent[var_of(root1)] = is_negative(root1) ? negate(root2) : root2;
+}
+
+literal sat_preprocessor::find_equal(literal lit) {
+    auto root = make_literal(var_of(lit), false);
+    while (equal_parent[var_of(root)] != make_literal(var_of(root), false)) {
+        auto parent = equal_parent[var_of(root)];
+        root = is_negative(root) ? negate(parent) : parent;
+    }
+    // path compression, every literal on the path is equal to the root
+    auto current = make_literal(var_of(lit), false);
+    while (var_of(current) != var_of(root)) {
+        auto parent = equal_parent[var_of(current)];
+        equal_parent[var_of(current)] = is_negative(current) ? negate(root) : root;
+        current = is_negative(current) ? negate(parent) : parent;
+    }
+    return is_negative(lit) ? negate(root) : root;
+}
+
+// Removes duplicate and subsumed clauses, which are left by resolution and substitution of equal literals,
+// and strengthens clauses by self-subsuming resolution
+bool sat_preprocessor::subsume_clauses() {
+    if (is_interrupted())
+        return false;
+
+    info("Started subsumption...")
+    auto old_subsumed = subsumer.subsumed;
+    auto old_strengthened = subsumer.strengthened;
+    auto old_ticks = subsumer.ticks;
+    if (pool.size() == 1) {
+        subsumer.run(clauses, nb_vars, true, subsumption_ticks, [](uint32_t, uint32_t) {});
+    } else {
+        subsumer.run_parallel(clauses, nb_vars, true, subsumption_ticks, pool, [](uint32_t, uint32_t) {});
+    }
+    ticks += subsumer.ticks - old_ticks;
+    clauses_subsumed += subsumer.subsumed - old_subsumed;
+    clauses_strengthened += subsumer.strengthened - old_strengthened;
+
+    clauses.erase(
+            std::remove_if(clauses.begin(), clauses.end(), [](const auto& clause) {
+                return sat_utils::is_invalidated(clause);
+            }),
+            clauses.end()
+    );
+    for (const auto& clause: clauses) {
+        unsat |= clause.empty();
+    }
+    return subsumer.subsumed != old_subsumed || subsumer.strengthened != old_strengthened;
+}
+
+std::vector<literal> sat_preprocessor::resolve(uint32_t var, const std::vector<literal>& clause1, const std::vector<literal>& clause2) {
+    std::vector<literal> result;
     result.insert(result.end(), clause1.begin(), clause1.end());
     result.insert(result.end(), clause2.begin(), clause2.end());
-    auto remove_var = std::remove(result.begin(), result.end(), var);
-    auto remove_nvar = std::remove(result.begin(), remove_var, -var);
+    auto remove_var = std::remove(result.begin(), result.end(), make_literal(var, false));
+    auto remove_nvar = std::remove(result.begin(), remove_var, make_literal(var, true));
     std::sort(result.begin(), remove_nvar);
     auto remove_unique = std::unique(result.begin(), remove_nvar);
     result.erase(remove_unique, result.end());
     return result;
 }
 
-bool sat_preprocessor::niver() {
+// Bounded variable elimination [4]: variables are tried in the order of the product of their positive and
+// negative occurrences, and tried again when their occurrences change
+bool sat_preprocessor::eliminate_variables() {
     if (is_interrupted())
         return false;
 
-    info("Started NiVER...")
+    info("Started BVE...")
     auto changed = false;
-    std::vector<int8_t> invalidated;
-    std::vector<std::vector<int>> pvar_clauses;
-    std::vector<std::vector<int>> nvar_clauses;
-    invalidated.resize(nb_vars + 1);
-    pvar_clauses.resize(nb_vars + 1);
-    nvar_clauses.resize(nb_vars + 1);
-    for (auto clause_id = 0; clause_id < clauses.size(); clause_id++) {
-        for (int signed_var: clauses[clause_id]) {
-            if (signed_var > 0) {
-                pvar_clauses[signed_var].push_back(clause_id);
-            } else {
-                nvar_clauses[-signed_var].push_back(clause_id);
-            }
-        }
+    occurrences.assign(2 * (nb_vars + 1), {});
+    for (uint32_t clause_id = 0; clause_id < clauses.size(); clause_id++) {
+        ticks += clauses[clause_id].size();
+        add_occurrences(clause_id);
     }
+    elimination_cost.assign(nb_vars + 1, 0);
+    touched.assign(nb_vars + 1, false);
+    marked.assign(2 * (nb_vars + 1), false);
+    std::vector<uint32_t> vars;
+    for (uint32_t var = 1; var <= nb_vars; var++) {
+        if (prior_values[var] != preprocessor_value_state::UNDEF)
+            continue;
 
-    for (auto var = 1; var <= nb_vars; var++) {
-        if (is_interrupted())
-            break;
+        elimination_cost[var] = (uint64_t) occurrences[make_literal(var, false)].size()
+                                * occurrences[make_literal(var, true)].size();
+        vars.push_back(var);
+    }
+    elimination_queue.rebuild_heap(vars);
 
-        if (prior_values[var] != preprocessor_value_state::UNDEF || invalidated[var])
-            continue;
+    if (pool.size() > 1) {
+        changed = eliminate_in_batches();
+    } else {
+        while (elimination_queue.size() > 0 && !is_interrupted()) {
+            auto var = elimination_queue.extract_min();
+            if (!try_eliminate(var))
+                continue;
 
-        if (pvar_clauses[var].empty() && nvar_clauses[var].empty()) {
             changed = true;
-            prior_values[var] = preprocessor_value_state::ANY;
-            continue;
+            update_touched_costs();
         }
+    }
+    occurrences.clear();
+    return changed;
+}
 
-        debug(
-            for (int pclause_id: pvar_clauses[var]) {
-                if (sat_utils::is_invalidated(clauses[pclause_id]))
-                    debug_logic_error("Deleted clause encountered")
+// Takes variables from the queue whose clauses contain none of the variables of the clauses of the variables
+// taken before, so their eliminations don't interfere. Resolvents are found on the threads of the pool and
+// the eliminations are applied in the order of the queue, variables left out of a batch go back to the queue.
+bool sat_preprocessor::eliminate_in_batches() {
+    auto changed = false;
+    auto tasks = pool.size();
+    auto batch_limit = tasks * elimination_batch_size;
+    std::vector<std::vector<bool>> task_marks(tasks, std::vector<bool>(2 * (nb_vars + 1)));
+    std::vector<int64_t> task_ticks(tasks);
+    std::vector<bool> locked(nb_vars + 1);
+    std::vector<uint32_t> locked_vars;
+    std::vector<uint32_t> batch;
+    std::vector<uint32_t> deferred;
+    std::vector<std::vector<std::vector<literal>>> batch_resolvents(batch_limit);
+    // written by the tasks, std::vector<bool> packs elements into shared words
+    std::vector<uint8_t> bounded(batch_limit);
+    while (elimination_queue.size() > 0 && !is_interrupted()) {
+        batch.clear();
+        deferred.clear();
+        for (size_t taken = 0; taken < 2 * batch_limit && batch.size() < batch_limit
+                               && elimination_queue.size() > 0; taken++) {
+            auto var = elimination_queue.extract_min();
+            const auto& positive = occurrences[make_literal(var, false)];
+            const auto& negative = occurrences[make_literal(var, true)];
+            if (positive.size() > max_elimination_occurrences || negative.size() > max_elimination_occurrences)
+                continue;
+
+            auto independent = true;
+            for (const auto* list: {&positive, &negative}) {
+                for (auto clause_id: *list) {
+                    ticks += clauses[clause_id].size();
+                    for (auto lit: clauses[clause_id]) {
+                        independent &= !locked[var_of(lit)];
+                    }
+                }
             }
-            for (int nclause_id: nvar_clauses[var]) {
-                if (sat_utils::is_invalidated(clauses[nclause_id]))
-                    debug_logic_error("Deleted clause encountered")
+            if (!independent) {
+                deferred.push_back(var);
+                continue;
             }
-        )
 
-        auto old_size = 0;
-        auto new_size = 0;
-        for (int pclause_id: pvar_clauses[var]) {
-            old_size += clauses[pclause_id].size();
-        }
-        for (int nclause_id: nvar_clauses[var]) {
-            old_size += clauses[nclause_id].size();
-        }
-        std::vector<std::vector<int>> new_clauses;
-        for (int pclause_id: pvar_clauses[var]) {
-            for (int nclause_id: nvar_clauses[var]) {
-                auto new_clause = resolve(var, clauses[pclause_id], clauses[nclause_id]);
-                if (!sat_utils::is_tautology(new_clause)) {
-                    new_clauses.push_back(new_clause);
-                    new_size += new_clause.size();
-                    if (new_size > old_size)
-                        break;
+            for (const auto* list: {&positive, &negative}) {
+                for (auto clause_id: *list) {
+                    for (auto lit: clauses[clause_id]) {
+                        if (!locked[var_of(lit)]) {
+                            locked[var_of(lit)] = true;
+                            locked_vars.push_back(var_of(lit));
+                        }
+                    }
                 }
             }
-            if (new_size > old_size)
-                break;
+            batch.push_back(var);
+        }
+        for (auto var: deferred) {
+            elimination_queue.insert(var);
         }
 
-        if (new_size <= old_size) {
-            if (pvar_clauses[var].size() == 0) {
-                set_signed_prior_value(-var);
-            } else if (nvar_clauses[var].size() == 0) {
-                set_signed_prior_value(var);
-            } else {
-                prior_values[var] = preprocessor_value_state::VER;
-                std::vector<std::vector<int>> ver_clauses;
-                for (int pclause_id: pvar_clauses[var]) {
-                    ver_clauses.push_back(clauses[pclause_id]);
-                }
-                for (int nclause_id: nvar_clauses[var]) {
-                    ver_clauses.push_back(clauses[nclause_id]);
-                }
-                remapper.add_ver_var(var, ver_clauses);
+        pool.run(tasks, [&](uint32_t task) {
+            for (auto i = task; i < batch.size(); i += tasks) {
+                bounded[i] = find_resolvents(batch[i], task_marks[task], task_ticks[task], batch_resolvents[i]);
             }
-            for (int pclause_id: pvar_clauses[var]) {
-                for (int signed_var: clauses[pclause_id]) {
-                    invalidated[abs(signed_var)] = true;
-                }
-                sat_utils::invalidate_clause(clauses[pclause_id]);
+        });
+        for (auto& task_tick: task_ticks) {
+            ticks += task_tick;
+            task_tick = 0;
+        }
+
+        for (size_t i = 0; i < batch.size(); i++) {
+            if (bounded[i]) {
+                eliminate(batch[i], batch_resolvents[i]);
+                changed = true;
             }
-            for (int nclause_id: nvar_clauses[var]) {
-                for (int signed_var: clauses[nclause_id]) {
-                    invalidated[abs(signed_var)] = true;
+            batch_resolvents[i].clear();
+        }
+        for (auto var: locked_vars) {
+            locked[var] = false;
+        }
+        locked_vars.clear();
+        update_touched_costs();
+    }
+    return changed;
+}
+
+void sat_preprocessor::update_touched_costs() {
+    for (auto touched_var: touched_vars) {
+        touched[touched_var] = false;
+        if (prior_values[touched_var] == preprocessor_value_state::UNDEF)
+            update_elimination_cost(touched_var);
+    }
+    touched_vars.clear();
+}
+
+// Replaces the clauses of a variable with their non-tautological resolvents, unless there are more than
+// elimination_growth resolvents over the number of the clauses or some of them are too long
+bool sat_preprocessor::try_eliminate(uint32_t var) {
+    if (occurrences[make_literal(var, false)].size() > max_elimination_occurrences
+        || occurrences[make_literal(var, true)].size() > max_elimination_occurrences)
+        return false;
+
+    std::vector<std::vector<literal>> resolvents;
+    if (!find_resolvents(var, marked, ticks, resolvents))
+        return false;
+
+    eliminate(var, resolvents);
+    return true;
+}
+
+// Reads the clauses only, so independent variables are resolved concurrently with their own marks and ticks
+bool sat_preprocessor::find_resolvents(uint32_t var, std::vector<bool>& literal_marks, int64_t& task_ticks,
+                                       std::vector<std::vector<literal>>& resolvents) const {
+    const auto& positive = occurrences[make_literal(var, false)];
+    const auto& negative = occurrences[make_literal(var, true)];
+    // resolvents are counted on marked literals of the positive clause first, most attempts fail
+    auto max_resolvents = (int64_t) (positive.size() + negative.size()) + elimination_growth;
+    int64_t resolvent_count = 0;
+    auto bounded = true;
+    for (auto pclause_id: positive) {
+        const auto& pclause = clauses[pclause_id];
+        for (auto lit: pclause) {
+            literal_marks[lit] = true;
+        }
+        for (auto nclause_id: negative) {
+            const auto& nclause = clauses[nclause_id];
+            task_ticks += pclause.size() + nclause.size();
+            auto size = pclause.size() - 1;
+            auto tautology = false;
+            for (auto lit: nclause) {
+                if (var_of(lit) == var || literal_marks[lit])
+                    continue;
+
+                if (literal_marks[negate(lit)]) {
+                    tautology = true;
+                    break;
                 }
-                sat_utils::invalidate_clause(clauses[nclause_id]);
+                size++;
+            }
+            if (tautology)
+                continue;
+
+            if (size > max_resolvent_size || ++resolvent_count > max_resolvents) {
+                bounded = false;
+                break;
             }
-            clauses.insert(clauses.end(), new_clauses.begin(), new_clauses.end());
-            changed = true;
-            niver_eliminated++;
         }
+        for (auto lit: pclause) {
+            literal_marks[lit] = false;
+        }
+        if (!bounded)
+            return false;
+    }
+
+    for (auto pclause_id: positive) {
+        for (auto nclause_id: negative) {
+            auto resolvent = resolve(var, clauses[pclause_id], clauses[nclause_id]);
+            if (!sat_utils::is_tautology(resolvent))
+                resolvents.push_back(std::move(resolvent));
+        }
+    }
+    return true;
+}
+
+void sat_preprocessor::eliminate(uint32_t var, std::vector<std::vector<literal>>& resolvents) {
+    const auto& positive = occurrences[make_literal(var, false)];
+    const auto& negative = occurrences[make_literal(var, true)];
+    if (positive.empty() && negative.empty()) {
+        prior_values[var] = preprocessor_value_state::ANY;
+        return;
+    }
+
+    if (positive.empty()) {
+        set_prior_value(make_literal(var, true));
+    } else if (negative.empty()) {
+        set_prior_value(make_literal(var, false));
+    } else {
+        prior_values[var] = preprocessor_value_state::VER;
+        std::vector<std::vector<int>> ver_clauses;
+        for (auto pclause_id: positive) {
+            ver_clauses.push_back(to_signed(clauses[pclause_id]));
+        }
+        for (auto nclause_id: negative) {
+            ver_clauses.push_back(to_signed(clauses[nclause_id]));
+        }
+        remapper.add_ver_var(var, ver_clauses);
+    }
+
+    std::vector<uint32_t> removed(positive.begin(), positive.end());
+    removed.insert(removed.end(), negative.begin(), negative.end());
+    remove_clauses(removed);
+    for (auto& resolvent: resolvents) {
+        touch_vars(resolvent);
+        clauses.push_back(std::move(resolvent));
+        add_occurrences(clauses.size() - 1);
+    }
+    variables_eliminated++;
+}
+
+void sat_preprocessor::add_occurrences(uint32_t clause_id) {
+    for (auto lit: clauses[clause_id]) {
+        occurrences[lit].push_back(clause_id);
+    }
+}
+
+// Deletes the clauses at once, the last clause takes the place of a deleted one
+void sat_preprocessor::remove_clauses(std::vector<uint32_t>& clause_ids) {
+    // in descending order, a moved clause is never one of the deleted ones
+    std::sort(clause_ids.begin(), clause_ids.end(), std::greater<>());
+    clause_ids.erase(std::unique(clause_ids.begin(), clause_ids.end()), clause_ids.end());
+    auto replace_occurrence = [this](literal lit, uint32_t from, uint32_t to) {
+        auto& list = occurrences[lit];
+        ticks += list.size();
+        *std::find(list.begin(), list.end(), from) = to;
+    };
+    for (auto clause_id: clause_ids) {
+        touch_vars(clauses[clause_id]);
+        for (auto lit: clauses[clause_id]) {
+            auto& list = occurrences[lit];
+            replace_occurrence(lit, clause_id, list.back());
+            list.pop_back();
+        }
+        auto last_id = (uint32_t) clauses.size() - 1;
+        if (clause_id != last_id) {
+            for (auto lit: clauses[last_id]) {
+                replace_occurrence(lit, last_id, clause_id);
+            }
+            clauses[clause_id] = std::move(clauses[last_id]);
+        }
+        clauses.pop_back();
+    }
+}
+
+void sat_preprocessor::touch_vars(const std::vector<literal>& clause) {
+    for (auto lit: clause) {
+        auto var = var_of(lit);
+        if (!touched[var]) {
+            touched[var] = true;
+            touched_vars.push_back(var);
+        }
+    }
+}
+
+void sat_preprocessor::update_elimination_cost(uint32_t var) {
+    auto old_cost = elimination_cost[var];
+    elimination_cost[var] = (uint64_t) occurrences[make_literal(var, false)].size()
+                            * occurrences[make_literal(var, true)].size();
+    if (!elimination_queue.in_heap(var)) {
+        elimination_queue.insert(var);
+    } else if (elimination_cost[var] < old_cost) {
+        elimination_queue.decrease(var);
+    } else if (elimination_cost[var] > old_cost) {
+        elimination_queue.increase(var);
+    }
+}
+
+// Blocked clause elimination [12]: a clause is blocked on its literal if all resolvents on the literal are
+// tautologies. Literals are tried in the order of the number of their resolution partners, and tried again
+// when a clause containing their negation is removed. Removed clauses are kept by the remapper, which flips
+// the blocking literal if the model falsifies the clause.
+bool sat_preprocessor::eliminate_blocked_clauses() {
+    if (!blocked_clause_rounds || is_interrupted())
+        return false;
+
+    info("Started BCE...")
+    auto start_ticks = ticks;
+    auto old_blocked = clauses_blocked;
+    occurrences.assign(2 * (nb_vars + 1), {});
+    for (uint32_t clause_id = 0; clause_id < clauses.size(); clause_id++) {
+        ticks += clauses[clause_id].size();
+        add_occurrences(clause_id);
+    }
+    blocking_cost.assign(2 * (nb_vars + 1), 0);
+    touched.assign(nb_vars + 1, false);
+    marked.assign(2 * (nb_vars + 1), false);
+    std::vector<uint32_t> literals;
+    for (uint32_t var = 1; var <= nb_vars; var++) {
+        if (prior_values[var] != preprocessor_value_state::UNDEF)
+            continue;
+
+        for (auto lit: {make_literal(var, false), make_literal(var, true)}) {
+            blocking_cost[lit] = occurrences[negate(lit)].size();
+            if (!occurrences[lit].empty())
+                literals.push_back(lit);
+        }
+    }
+    blocking_queue.rebuild_heap(literals);
+
+    std::vector<uint32_t> blocked;
+    while (blocking_queue.size() > 0 && !is_interrupted() && ticks - start_ticks < blocked_clause_ticks) {
+        auto lit = blocking_queue.extract_min();
+        // the queue is ordered by the number of partners, the remaining literals have too many
+        if (blocking_cost[lit] > max_blocking_occurrences)
+            break;
+
+        // removing a clause blocked on the literal doesn't change the partners of the others
+        blocked.clear();
+        for (auto clause_id: occurrences[lit]) {
+            if (is_blocked(clause_id, lit))
+                blocked.push_back(clause_id);
+        }
+        if (blocked.empty())
+            continue;
+
+        for (auto clause_id: blocked) {
+            remapper.add_blocked_clause(var_of(lit), to_signed(clauses[clause_id]));
+        }
+        clauses_blocked += blocked.size();
+        remove_clauses(blocked);
+        for (auto touched_var: touched_vars) {
+            touched[touched_var] = false;
+            update_blocking_cost(make_literal(touched_var, false));
+            update_blocking_cost(make_literal(touched_var, true));
+        }
+        touched_vars.clear();
+    }
+    occurrences.clear();
+    // later rounds find only a few clauses which became blocked, checking all literals again isn't worth it
+    blocked_clause_rounds = (clauses_blocked - old_blocked) * min_blocked_ratio >= (int64_t) clauses.size();
+    return clauses_blocked != old_blocked;
+}
+
+bool sat_preprocessor::is_blocked(uint32_t clause_id, literal lit) {
+    const auto& clause = clauses[clause_id];
+    for (auto clause_lit: clause) {
+        marked[clause_lit] = true;
+    }
+    auto blocked = true;
+    for (auto partner_id: occurrences[negate(lit)]) {
+        const auto& partner = clauses[partner_id];
+        ticks += partner.size();
+        auto tautology = false;
+        for (auto partner_lit: partner) {
+            if (partner_lit != negate(lit) && marked[negate(partner_lit)]) {
+                tautology = true;
+                break;
+            }
+        }
+        if (!tautology) {
+            blocked = false;
+            break;
+        }
+    }
+    for (auto clause_lit: clause) {
+        marked[clause_lit] = false;
+    }
+    return blocked;
+}
+
+// Clauses are only removed, so a literal which lost partners is queued again
+void sat_preprocessor::update_blocking_cost(literal lit) {
+    auto old_cost = blocking_cost[lit];
+    blocking_cost[lit] = occurrences[negate(lit)].size();
+    if (blocking_cost[lit] == old_cost || occurrences[lit].empty())
+        return;
+
+    if (!blocking_queue.in_heap(lit)) {
+        blocking_queue.insert(lit);
+    } else {
+        blocking_queue.decrease(lit);
     }
-    clauses.erase(
-            std::remove_if(clauses.begin(), clauses.end(), sat_utils::is_invalidated),
-            clauses.end()
-    );
-    return changed;
 }
 
 bool sat_preprocessor::propagate_all() {
@@ -413,26 +899,30 @@ bool sat_preprocessor::propagate_all() {
     while (changed && !is_interrupted()) {
         changed = false;
         for (auto& clause: clauses) {
+            ticks += clause.size();
             if (find_true_literal(clause) != clause.end())
                 continue;
 
             changed |= remove_false_literals(clause);
             if (clause.size() == 1) {
                 changed = true;
-                set_signed_prior_value(clause[0]);
+                set_prior_value(clause[0]);
                 propagated++;
             }
         }
-        for (const auto& [literal, set]: implication_graph) {
-            if (get_signed_prior_value(literal) != preprocessor_value_state::TRUE)
+        for (literal lit = 0; lit + 1 < implication_start.size(); lit++) {
+            ticks++;
+            if (get_prior_value(lit) != preprocessor_value_state::TRUE)
                 continue;
 
-            for (auto implied_literal: set) {
-                if (prior_values[abs(implied_literal)] != preprocessor_value_state::UNDEF)
+            ticks += implication_start[lit + 1] - implication_start[lit];
+            for (auto i = implication_start[lit]; i < implication_start[lit + 1]; i++) {
+                auto implied_literal = implication_targets[i];
+                if (prior_values[var_of(implied_literal)] != preprocessor_value_state::UNDEF)
                     continue;
 
                 changed = true;
-                set_signed_prior_value(implied_literal);
+                set_prior_value(implied_literal);
                 propagated++;
             }
         }
@@ -456,11 +946,11 @@ bool sat_preprocessor::remove_true_clauses() {
     return old_size != clauses.size();
 }
 
-bool sat_preprocessor::remove_false_literals(std::vector<int>& clause) {
+bool sat_preprocessor::remove_false_literals(std::vector<literal>& clause) {
     auto old_size = clause.size();
     clause.erase(
-            std::remove_if(clause.begin(), clause.end(), [this](int signed_var) {
-                return get_signed_prior_value(signed_var) == preprocessor_value_state::FALSE;
+            std::remove_if(clause.begin(), clause.end(), [this](literal lit) {
+                return get_prior_value(lit) == preprocessor_value_state::FALSE;
             }),
             clause.end()
     );
@@ -468,49 +958,45 @@ bool sat_preprocessor::remove_false_literals(std::vector<int>& clause) {
     return old_size != clause.size();
 }
 
-std::vector<int>::const_iterator sat_preprocessor::find_true_literal(const std::vector<int>& clause) {
-    return std::find_if(clause.begin(), clause.end(), [this](int signed_var) {
-        return get_signed_prior_value(signed_var) == preprocessor_value_state::TRUE;
+std::vector<literal>::const_iterator sat_preprocessor::find_true_literal(const std::vector<literal>& clause) {
+    return std::find_if(clause.begin(), clause.end(), [this](literal lit) {
+        return get_prior_value(lit) == preprocessor_value_state::TRUE;
     });
 }
 
-preprocessor_value_state sat_preprocessor::get_signed_prior_value(int signed_var) {
-    auto value = prior_values[abs(signed_var)];
+preprocessor_value_state sat_preprocessor::get_prior_value(literal lit) {
+    auto value = prior_values[var_of(lit)];
     if (value != preprocessor_value_state::TRUE && value != preprocessor_value_state::FALSE)
         return value;
 
-    if ((value == preprocessor_value_state::TRUE) ^ (signed_var < 0))
+    if ((value == preprocessor_value_state::TRUE) ^ is_negative(lit))
         return preprocessor_value_state::TRUE;
     else
         return preprocessor_value_state::FALSE;
 }
 
-void sat_preprocessor::set_signed_prior_value(int signed_var) {
-    debug(if (prior_values[abs(signed_var)] != preprocessor_value_state::UNDEF)
-        debug_logic_error("Tried to reassign value in preprocessing: " << signed_var))
+void sat_preprocessor::set_prior_value(literal lit) {
+    debug(if (prior_values[var_of(lit)] != preprocessor_value_state::UNDEF)
+        debug_logic_error("Tried to reassign value in preprocessing: " << to_signed(lit)))
 
-    if (signed_var > 0)
-        prior_values[signed_var] = preprocessor_value_state::TRUE;
-    else
-        prior_values[-signed_var] = preprocessor_value_state::FALSE;
+    prior_values[var_of(lit)] = is_negative(lit)
+            ? preprocessor_value_state::FALSE
+            : preprocessor_value_state::TRUE;
 }
 
 bool sat_preprocessor::is_interrupted() {
-    if (unsat)
-        return true;
-
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start_time);
-    return elapsed >= global_timeout;
+    return unsat || ticks >= tick_limit;
 }
 
-bool sat_preprocessor::is_interrupted_hyp_bin_res(std::chrono::steady_clock::time_point start) {
-    if (is_interrupted())
-        return true;
+bool sat_preprocessor::is_interrupted_hyp_bin_res(int64_t start_ticks) {
+    return is_interrupted() || ticks - start_ticks >= hyp_bin_res_ticks;
+}
 
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start);
-    return elapsed >= hyp_bin_res_timeout;
+// Checked between rounds only, so the result of preprocessing doesn't depend on the speed of the machine
+// unless it's unexpectedly slow
+bool sat_preprocessor::is_timed_out() {
+    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start_time);
+    return elapsed >= global_timeout;
 }
 
 bool sat_preprocessor::check_unsat() {
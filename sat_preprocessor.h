@@ -2,52 +2,146 @@
 #define SATSOLVER_SAT_PREPROCESSOR_H
 
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 #include "debug.h"
 #include "dimacs.h"
+#include "min_heap.h"
 #include "sat_remapper.h"
+#include "subsumption.h"
+#include "solver_types.h"
+#include "thread_pool.h"
+
+// Orders variables by ascending cost of elimination, variables of equal cost by index
+class elimination_compare {
+    const std::vector<uint64_t>& cost;
+
+public:
+    elimination_compare(const std::vector<uint64_t>& cost) : cost(cost) {}
+
+    bool operator()(uint32_t a, uint32_t b) {
+        if (cost[a] != cost[b])
+            return cost[a] < cost[b];
+        return a < b;
+    }
+};
+
+// Scratch space and results of hyper-binary resolution over a block of clauses
+struct hyp_bin_res_block {
+    // number of literals of the current clause implying a literal, nonzero only for the counted literals
+    std::vector<uint32_t> literal_count;
+    std::vector<literal> counted;
+    std::vector<std::pair<literal, literal>> edges;
+    std::vector<literal> units;
+    int64_t ticks = 0;
+};
 
 class sat_preprocessor {
     uint32_t nb_vars;
-    std::vector<std::vector<int>> clauses;
+    std::vector<std::vector<literal>> clauses;
     std::vector<preprocessor_value_state> prior_values;
-    std::unordered_map<int, std::unordered_set<int>> implication_graph;
+    // sorted implications of each literal in compressed sparse row format:
+    // implication_targets[implication_start[lit]..implication_start[lit + 1])
+    std::vector<uint32_t> implication_start;
+    std::vector<literal> implication_targets;
+    // edges added since the last rebuild of the rows, merged in batches
+    std::vector<std::pair<literal, literal>> pending_edges;
+    // union-find of equivalent literals: equal_parent[var] is a literal equal to the positive literal of var
+    std::vector<literal> equal_parent;
+    // clauses containing a literal, maintained by clause and variable elimination while they run
+    std::vector<std::vector<uint32_t>> occurrences;
+    // product of the numbers of positive and negative occurrences
+    std::vector<uint64_t> elimination_cost;
+    min_heap<uint32_t, elimination_compare> elimination_queue;
+    // number of resolution partners of a literal: the occurrences of its negation
+    std::vector<uint64_t> blocking_cost;
+    min_heap<uint32_t, elimination_compare> blocking_queue;
+    // whether the next round runs blocked clause elimination, off unless requested
+    bool blocked_clause_rounds;
+    // variables whose occurrences changed with the last elimination
+    std::vector<uint32_t> touched_vars;
+    std::vector<bool> touched;
+    std::vector<bool> marked;
+    // number of clauses an elimination may add over the ones it removes
+    int32_t elimination_growth;
+    subsumption subsumer;
+    // with more than one thread, HypBinRes, subsumption and BVE run their parallel versions
+    thread_pool pool;
     sat_remapper remapper;
     bool unsat;
     std::chrono::steady_clock::time_point start_time;
+    // deterministic measure of work: clause literals and implication edges visited
+    int64_t ticks;
 
     // statistics
     int64_t propagated;
-    int64_t niver_eliminated;
+    int64_t variables_eliminated;
+    int64_t clauses_blocked;
+    int64_t clauses_subsumed;
+    int64_t clauses_strengthened;
     int64_t hyp_bin_res_resolved;
     int64_t equality_eliminated;
 
+    static constexpr int64_t tick_limit = 1000000000;
+    static constexpr int64_t hyp_bin_res_ticks = 150000000;
+    static constexpr int64_t subsumption_ticks = 100000000;
+    static constexpr int64_t blocked_clause_ticks = 100000000;
+    // HypBinRes merges the pending edges once there are this many plus a quarter of the rows
+    static constexpr size_t min_rebuild_edges = 65536;
+    // variables with more occurrences of a literal or longer resolvents are not eliminated
+    static constexpr size_t max_elimination_occurrences = 32;
+    static constexpr size_t max_resolvent_size = 24;
+    // parallel HypBinRes resolves blocks of this many clauses, parallel BVE tries batches of this many
+    // independent variables per thread
+    static constexpr size_t hyp_bin_res_block_size = 4096;
+    static constexpr size_t elimination_batch_size = 16;
+    // literals with more resolution partners are not tried as blocking literals
+    static constexpr size_t max_blocking_occurrences = 64;
+    // blocked clause elimination stops after a round which removes fewer clauses than this fraction of them
+    static constexpr int64_t min_blocked_ratio = 1000;
+    // safety limit only, the amount of preprocessing is bounded by ticks
     static constexpr std::chrono::seconds global_timeout {40};
-    static constexpr std::chrono::seconds hyp_bin_res_timeout {5};
 public:
-    explicit sat_preprocessor(const dimacs& formula);
+    explicit sat_preprocessor(const dimacs& formula, int32_t elimination_growth = 0,
+                              bool blocked_clause_elimination = false, uint32_t threads = 1);
     std::pair<dimacs, sat_remapper> preprocess();
 
 private:
     bool propagate_all();
-    bool niver();
+    bool eliminate_variables();
+    bool eliminate_blocked_clauses();
     bool hyper_binary_resolution();
     bool eliminate_equality();
+    bool subsume_clauses();
 
-    void filter_implication_graph();
+    bool try_eliminate(uint32_t var);
+    bool eliminate_in_batches();
+    bool find_resolvents(uint32_t var, std::vector<bool>& literal_marks, int64_t& task_ticks,
+                         std::vector<std::vector<literal>>& resolvents) const;
+    void eliminate(uint32_t var, std::vector<std::vector<literal>>& resolvents);
+    void update_touched_costs();
+    void hyper_binary_resolve(const std::vector<literal>& clause, hyp_bin_res_block& block) const;
+    bool is_blocked(uint32_t clause_id, literal lit);
+    void update_blocking_cost(literal lit);
+    void add_occurrences(uint32_t clause_id);
+    void remove_clauses(std::vector<uint32_t>& clause_ids);
+    void touch_vars(const std::vector<literal>& clause);
+    void update_elimination_cost(uint32_t var);
+    void rebuild_implication_graph();
+    void unite_strongly_connected();
+    void unite_equal(literal lit1, literal lit2);
+    literal find_equal(literal lit);
     bool is_interrupted();
-    bool is_interrupted_hyp_bin_res(std::chrono::steady_clock::time_point start);
+    bool is_interrupted_hyp_bin_res(int64_t start_ticks);
+    bool is_timed_out();
     bool check_unsat();
     debug_def(void print_clause_statistics();)
-    void add_implication_edge(int from, int to);
-    bool has_implication_edge(int from, int to);
-    std::vector<int> resolve(int var, const std::vector<int>& clause1, const std::vector<int>& clause2);
+    void add_implication_edge(literal from, literal to);
+    bool has_implication_edge(literal from, literal to) const;
+    static std::vector<literal> resolve(uint32_t var, const std::vector<literal>& clause1, const std::vector<literal>& clause2);
     bool remove_true_clauses();
-    bool remove_false_literals(std::vector<int>& clause);
-    std::vector<int>::const_iterator find_true_literal(const std::vector<int>& clause);
-    void set_signed_prior_value(int signed_var);
-    preprocessor_value_state get_signed_prior_value(int signed_var);
+    bool remove_false_literals(std::vector<literal>& clause);
+    std::vector<literal>::const_iterator find_true_literal(const std::vector<literal>& clause);
+    void set_prior_value(literal lit);
+    preprocessor_value_state get_prior_value(literal lit);
 };
 
 #endif //SATSOLVER_SAT_PREPROCESSOR_H
@@ -33,6 +33,10 @@ void sat_remapper::add_eq_var(int var, int eq_var) {
     remap_events.emplace_back(var, remap_event::create_eq(eq_var));
 }
 
+void sat_remapper::add_blocked_clause(int var, const std::vector<int>& clause) {
+    remap_events.emplace_back(var, remap_event::create_blocked(clause));
+}
+
 std::vector<int8_t> sat_remapper::remap(std::vector<int8_t> values) {
     std::vector<preprocessor_value_state> result;
     result.push_back(preprocessor_value_state::UNDEF);
@@ -110,6 +114,29 @@ std::vector<int8_t> sat_remapper::remap(std::vector<int8_t> values) {
                 result[var] = value ? preprocessor_value_state::TRUE : preprocessor_value_state::FALSE;
                 break;
             }
+            case remap_event_type::BLOCKED: {
+                // a false blocked clause is satisfied by flipping its blocking literal, all resolvents
+                // on the literal are tautologies, so clauses removed later stay satisfied
+                auto satisfied = false;
+                auto blocking_literal = 0;
+                for (int signed_var: event.blocked_clause) {
+                    if (abs(signed_var) == var)
+                        blocking_literal = signed_var;
+
+                    auto value = result[abs(signed_var)];
+                    debug(if (value != preprocessor_value_state::TRUE && value != preprocessor_value_state::FALSE)
+                        debug_logic_error("Expected TRUE or FALSE in blocked clause, found: " << (int) value))
+
+                    if ((value == preprocessor_value_state::TRUE && signed_var > 0) ||
+                        (value == preprocessor_value_state::FALSE && signed_var < 0)) {
+                        satisfied = true;
+                        break;
+                    }
+                }
+                if (!satisfied)
+                    result[var] = blocking_literal > 0 ? preprocessor_value_state::TRUE : preprocessor_value_state::FALSE;
+                break;
+            }
         }
     }
     std::vector<int8_t> bool_result;
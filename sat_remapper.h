@@ -9,19 +9,22 @@ enum class preprocessor_value_state {
 };
 
 enum class remap_event_type {
-    VER, EQ
+    VER, EQ, BLOCKED
 };
 
 struct remap_event {
     remap_event_type type;
     std::vector<std::vector<int>> ver_clauses;
     int eq_var;
+    // removed clause, blocked on the literal of the variable of the event
+    std::vector<int> blocked_clause;
 
     static remap_event create_ver(const std::vector<std::vector<int>>& clauses) {
         return {
             remap_event_type::VER,
             clauses,
-            0
+            0,
+            {}
         };
     }
 
@@ -29,7 +32,17 @@ struct remap_event {
         return {
             remap_event_type::EQ,
             {},
-            eq_var
+            eq_var,
+            {}
+        };
+    }
+
+    static remap_event create_blocked(const std::vector<int>& clause) {
+        return {
+            remap_event_type::BLOCKED,
+            {},
+            0,
+            clause
         };
     }
 };
@@ -49,6 +62,7 @@ public:
     void add_ver_var(int var, const std::vector<std::vector<int>>& clauses);
     void add_any_var(int var);
     void add_eq_var(int var, int eq_var);
+    void add_blocked_clause(int var, const std::vector<int>& clause);
     std::vector<int8_t> remap(std::vector<int8_t> values);
 };
 
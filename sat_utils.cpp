@@ -24,4 +24,28 @@ namespace sat_utils {
     bool is_invalidated(const std::vector<int>& clause) {
         return clause.size() == 1 && clause[0] == 0;
     };
+
+    bool is_tautology(const std::vector<literal>& clause) {
+        // the preprocessor resolves on several threads
+        static thread_local std::unordered_set<uint32_t> used_vars;
+
+        used_vars.clear();
+        for (auto lit: clause) {
+            auto var = var_of(lit);
+            if (used_vars.find(var) != used_vars.end())
+                return true;
+
+            used_vars.insert(var);
+        }
+        return false;
+    }
+
+    // literal 0 belongs to the unused variable 0, so it can mark a deleted clause
+    void invalidate_clause(std::vector<literal>& clause) {
+        clause = std::vector<literal> {0};
+    };
+
+    bool is_invalidated(const std::vector<literal>& clause) {
+        return clause.size() == 1 && clause[0] == 0;
+    };
 }
@@ -2,11 +2,16 @@
 #define SATSOLVER_SAT_UTILS_H
 
 #include <vector>
+#include "solver_types.h"
 
 namespace sat_utils {
     void invalidate_clause(std::vector<int>& clause);
     bool is_invalidated(const std::vector<int>& clause);
     bool is_tautology(const std::vector<int>& clause);
+
+    void invalidate_clause(std::vector<literal>& clause);
+    bool is_invalidated(const std::vector<literal>& clause);
+    bool is_tautology(const std::vector<literal>& clause);
 }
 
 #endif //SATSOLVER_SAT_UTILS_H
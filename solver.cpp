@@ -6,192 +6,425 @@
 #include <cmath>
 #include <cstdlib>
 #include <algorithm>
-#include <random>
-#include <unordered_set>
-#include <queue>
+#include <unistd.h>
 
-solver::solver(const dimacs &formula, std::chrono::seconds timeout)
+template <typename Config>
+solver<Config>::solver(const dimacs &formula, std::chrono::seconds timeout, const solver_options& options)
         : nb_vars(formula.nb_vars),
-          vsids(*this),
+          options(options),
+          heuristic(*this, options.heuristic),
+          restarts(options),
+          random(options.seed),
+          find_non_false(watch_search::select(options.watch_search)),
+          walker(*this),
+          parallel_prober(*this),
           priors(0),
           decisions(0),
           propagations(0),
+          ticks(0),
           conflicts(0),
+          learnt_binary_count(0),
+          learnt_count(0),
+          learnt_literals(0),
+          minimized_literals(0),
+          reductions(0),
+          reduced_clauses(0),
+          subsumed_clauses(0),
+          garbage_collections(0),
+          restart_count(0),
+          reused_levels(0),
+          rephase_count(0),
+          chrono_backtracks(0),
+          lower_conflicts(0),
+          walk_count(0),
+          probe_rounds(0),
+          failed_literals(0),
+          hyper_binaries(0),
+          equivalences(0),
           timeout(timeout) {
     // init prior values
     prior_values.resize(nb_vars + 1);
     std::fill(prior_values.begin(), prior_values.end(), UNDEF);
 
-    // init clauses
-    for (const auto& clause: formula.clauses) {
-        if (clause.size() == 1) {
-            set_prior_value(clause[0]);
+    // init clauses, binary clauses are kept only in implication lists
+    implications.resize(2 * (nb_vars + 1));
+    probe_dirty.assign(nb_vars + 1, true);
+    // an empty clause or contradictory units, possible without preprocessing
+    auto trivially_unsat = false;
+    for (const auto& signed_clause: formula.clauses) {
+        auto clause = to_literals(signed_clause);
+        if (clause.empty()) {
+            trivially_unsat = true;
+        } else if (clause.size() == 1) {
+            auto prior = prior_values[var_of(clause[0])];
+            if (prior != UNDEF && prior != (is_negative(clause[0]) ? FALSE : TRUE)) {
+                trivially_unsat = true;
+            } else {
+                set_prior_value(clause[0]);
+            }
+        } else if (clause.size() == 2) {
+            add_binary_clause(clause[0], clause[1]);
         } else {
-            clauses.push_back(clause);
+            original_clauses.push_back(clauses.alloc(clause, false));
         }
     }
-    initial_clauses_count = clauses.size();
+    learnt_clauses_start = clauses.end_ref();
 
-    init(false);
+    init();
+    // init may have found a conflict on its own while propagating and probing the units
+    unsat = unsat || trivially_unsat;
 }
 
-void solver::init(bool restart) {
-    debug(if (!propagation_queue.empty())
-        debug_logic_error("Propagation queue is not empty on restart"))
-
-    if (restart) {
-        backtrack_until(0);
+template <typename Config>
+void solver<Config>::init() {
+    unsat = false;
+    conflict_reason = reason();
+    values_count = 0;
+    next_clock_poll = clock_poll_ticks;
+
+    // init learnt clauses reduction and restarts
+    reduce_interval = reduce_interval_init;
+    next_reduce = reduce_interval;
+    clause_activity_inc = 1.0;
+    restarts.init();
+    rephase_interval = rephase_interval_init;
+    next_rephase = rephase_interval;
+    probe_interval = probe_interval_init;
+    next_probe = probe_interval;
+    walk_interval = walk_interval_init;
+    next_walk = walk_interval;
+    walk_ticks = 0;
+    subsume_ticks = 0;
+
+    // init decision heuristic
+    heuristic.init();
+
+    // init values
+    values.resize(2 * (nb_vars + 1) + watch_search::value_padding);
+    std::fill(values.begin(), values.end(), UNDEF);
+    unassigned_vars.init(nb_vars);
+
+    // init antecedents
+    antecedents.resize(nb_vars + 1);
+    std::fill(antecedents.begin(), antecedents.end(), reason());
+
+    // init var to decision level
+    var_to_decision_level.resize(nb_vars + 1);
+
+    // init phases
+    saved_phases.resize(nb_vars + 1);
+    for (auto var = 1; var <= nb_vars; var++) {
+        saved_phases[var] = initial_polarity() ? TRUE : FALSE;
+    }
+    target_phases.resize(nb_vars + 1);
+    std::fill(target_phases.begin(), target_phases.end(), UNDEF);
+    best_phases.resize(nb_vars + 1);
+    std::fill(best_phases.begin(), best_phases.end(), UNDEF);
+    target_assigned = 0;
+    best_assigned = 0;
+
+    // init trail and conflict analysis state
+    trail.reserve(nb_vars);
+    binary_propagation_head = 0;
+    propagation_head = 0;
+    seen_stamps.resize(nb_vars + 1);
+    std::fill(seen_stamps.begin(), seen_stamps.end(), 0);
+    seen_epoch = 0;
+    level_stamps.resize(nb_vars + 1);
+    std::fill(level_stamps.begin(), level_stamps.end(), 0);
+    level_epoch = 0;
+    probe_stamps.resize(nb_vars + 1);
+    std::fill(probe_stamps.begin(), probe_stamps.end(), 0);
+    probe_epoch = 0;
+    probe_values.resize(nb_vars + 1);
+    probe_parents.resize(nb_vars + 1);
+    probe_depths.resize(nb_vars + 1);
 
-        debug(clause_filter.clear();)
-        pos_var_to_watch_clauses.clear();
-        neg_var_to_watch_clauses.clear();
-        watch_vars.clear();
+    // debug: init clause filter
+    if constexpr (Config::checks) {
+        for (auto cref: original_clauses) {
+            clause_filter.insert(filter_key(clauses[cref].begin(), clauses[cref].end()));
+        }
+    }
 
-        std::vector<std::pair<std::vector<int>, clause_stat>> learnt_clauses;
-        for (auto i = 0; i < clauses.size() - initial_clauses_count; i++) {
-            learnt_clauses.emplace_back(clauses[i + initial_clauses_count], learnt_clause_stat[i]);
+    // build 2-watch-literals structures, watched literals are the first two literals of a clause
+    watches.resize(2 * (nb_vars + 1));
+    for (auto cref: original_clauses) {
+        if constexpr (Config::checks) {
+            if (clauses[cref].size <= 1)
+                debug_logic_error("Size of initial clause is too small: " << clauses[cref].size)
         }
-        clauses.resize(initial_clauses_count);
-        learnt_clause_stat.clear();
+        watch_clause(cref);
+    }
 
-        std::sort(learnt_clauses.begin(), learnt_clauses.end(), [this](const auto& p1, const auto& p2) {
-            auto [lbd1, used1] = p1.second;
-            auto [lbd2, used2] = p2.second;
-            return lbd1 < lbd2;
-        });
-        auto rest_count = (int) (learnt_clauses.size() * clause_keep_ratio);
-        // Always keep 'glue' clauses
-        while (rest_count < learnt_clauses.size() && learnt_clauses[rest_count].second.lbd <= 2)
-            rest_count++;
+    select_propagation();
+    take_snapshot(0);
+    apply_prior_values();
+    probe_literals(initial_probe_ticks);
+    probe_ticks = ticks;
+}
 
-        for (auto i = 0; i < rest_count; i++) {
-            clauses.push_back(learnt_clauses[i].first);
-            learnt_clause_stat.emplace_back(learnt_clauses[i].second.lbd, learnt_clauses[i].second.used);
+// Probing candidates are roots of the binary implication graph: literals with binary implications that are not
+// implied by a binary clause themselves, failures and implications of their descendants are found through them.
+// Only variables whose binary neighborhood changed since they were probed are candidates.
+template <typename Config>
+void solver<Config>::collect_probes(std::vector<literal>& probes) {
+    probes.clear();
+    auto has_roots = false;
+    for (auto var = 1; var <= nb_vars; var++) {
+        for (auto lit: {make_literal(var, false), make_literal(var, true)}) {
+            if (!implications[negate(lit)].empty() && implications[lit].empty())
+                has_roots = true;
         }
+    }
+    for (auto var = 1; var <= nb_vars; var++) {
+        if (!probe_dirty[var] || get_value(make_literal(var, false)) != UNDEF)
+            continue;
 
-        current_clause_limit = (size_t) (current_clause_limit * clause_limit_inc_factor);
-    } else {
-        unsat = false;
-        conflict_clause = -1;
-        values_count = 0;
+        for (auto lit: {make_literal(var, false), make_literal(var, true)}) {
+            // on a graph made only of cycles every literal with implications is probed
+            if (!implications[negate(lit)].empty() && (implications[lit].empty() || !has_roots)) {
+                probes.push_back(lit);
+                probe_dirty[var] = false;
+                break;
+            }
+        }
+    }
+    random.shuffle(probes);
+}
 
-        current_clause_limit = (size_t) (clauses.size() * clause_limit_init_factor);
-        log_iteration = 0;
+// Rounds of failed literal probing limited by the number of ticks. Each probed literal is also probed
+// negated: literals implied both ways are units, literals implied with opposite values are equivalent to it.
+// Parallel probing handles batches of literals at once, sequential probing also learns hyper-binary resolvents.
+template <typename Config>
+void solver<Config>::probe_literals(int64_t budget) {
 
-        // init vsids score
-        vsids.init();
+    auto start_ticks = ticks;
+    while (!unsat && ticks - start_ticks < budget) {
+        collect_probes(probes);
+        if (probes.empty())
+            break;
 
-        // init values
-        values.resize(nb_vars + 1);
-        std::fill(values.begin(), values.end(), UNDEF);
+        probe_rounds++;
+        auto round_ticks = ticks;
+        auto old_failed = failed_literals;
+        auto old_priors = priors;
+        auto old_hyper_binaries = hyper_binaries;
+        auto old_equivalences = equivalences;
+        size_t probed = 0;
+        if (options.parallel_probing) {
+            auto old_prober_ticks = parallel_prober.ticks;
+            parallel_prober.build();
+            ticks += parallel_prober.ticks - old_prober_ticks;
+        }
+        while (probed < probes.size()) {
+            if (ticks - start_ticks >= budget) {
+                // the rest is probed in the next call
+                for (auto i = probed; i < probes.size(); i++) {
+                    probe_dirty[var_of(probes[i])] = true;
+                }
+                break;
+            }
+            if (options.parallel_probing) {
+                probe_parallel(probes, probed);
+            } else {
+                auto lit = probes[probed++];
+                if (get_value(lit) != UNDEF)
+                    continue;
+
+                probe_pair(lit);
+            }
+            if (unsat)
+                break;
+        }
 
-        // init antecedent clauses
-        antecedent_clauses.resize(nb_vars + 1);
-        std::fill(antecedent_clauses.begin(), antecedent_clauses.end(), -1);
+        info("Probing round " << probe_rounds << ": probed " << probed << " of " << probes.size()
+             << ", failed: " << failed_literals - old_failed
+             << ", lifted units: " << priors - old_priors - (failed_literals - old_failed)
+             << ", hyper-binary: " << hyper_binaries - old_hyper_binaries
+             << ", equivalences: " << equivalences - old_equivalences
+             << ", ticks: " << ticks - round_ticks)
+    }
+    if (unsat) {
+        info("UNSAT from literals probing")
+    }
+}
 
-        // init implied depth of variables
-        var_implied_depth.resize(nb_vars + 1);
-        std::fill(var_implied_depth.begin(), var_implied_depth.end(), 0);
+template <typename Config>
+void solver<Config>::probe_pair(literal lit) {
+    probe_epoch++;
+    if (probe_epoch == 0) {
+        std::fill(probe_stamps.begin(), probe_stamps.end(), 0);
+        probe_epoch = 1;
+    }
 
-        // init var to decision level
-        var_to_decision_level.resize(nb_vars + 1);
+    // implications of the literal are stamped with their values, then compared with the implications of its negation
+    if (!probe(lit))
+        return;
+    probe_units.clear();
+    probe_equivalent.clear();
+    auto first = snapshots.back().trail_length;
+    for (auto i = first + 1; i < trail.size(); i++) {
+        probe_stamps[var_of(trail[i])] = probe_epoch;
+        probe_values[var_of(trail[i])] = is_negative(trail[i]) ? FALSE : TRUE;
     }
+    backtrack();
 
-    // debug: init clause filter
-    debug(for (const auto& clause: clauses) {
-        clause_filter.insert(clause);
-    })
-
-    // build 2-watch-literals structures
-    pos_var_to_watch_clauses.resize(nb_vars + 1);
-    neg_var_to_watch_clauses.resize(nb_vars + 1);
-    watch_vars.resize(clauses.size());
-    for (auto i = 0; i < clauses.size(); i++) {
-        debug(if (clauses[i].size() <= 1)
-            debug_logic_error("Size of initial clause is too small: " << clauses[i].size()))
-        auto x = clauses[i][0];
-        auto y = clauses[i][1];
-        watch_vars[i] = std::make_pair(x, y);
-        if (x > 0) {
-            pos_var_to_watch_clauses[x].push_back(i);
-        } else {
-            neg_var_to_watch_clauses[-x].push_back(i);
-        }
-        if (y > 0) {
-            pos_var_to_watch_clauses[y].push_back(i);
+    if (!probe(negate(lit)))
+        return;
+    for (auto i = first + 1; i < trail.size(); i++) {
+        auto implied = trail[i];
+        if (probe_stamps[var_of(implied)] != probe_epoch)
+            continue;
+
+        if (probe_values[var_of(implied)] == (is_negative(implied) ? FALSE : TRUE)) {
+            probe_units.push_back(implied);
         } else {
-            neg_var_to_watch_clauses[-y].push_back(i);
+            probe_equivalent.push_back(implied);
         }
     }
+    backtrack();
 
-    take_snapshot(0);
-    apply_prior_values();
-    probe_literals();
+    for (auto implied: probe_equivalent) {
+        add_equivalence(lit, negate(implied));
+    }
+    for (auto unit: probe_units) {
+        if (get_value(unit) != UNDEF)
+            continue;
+
+        set_prior_value(unit);
+        set_value(unit, reason());
+        propagate_all(true);
+        if (unsat)
+            return;
+    }
+}
+
+// Probes the next batch of unassigned literals starting from `next`, units and equivalences are applied at once
+template <typename Config>
+void solver<Config>::probe_parallel(const std::vector<literal>& probes, size_t& next) {
+    probe_batch.clear();
+    while (next < probes.size() && probe_batch.size() < parallel_probing<solver>::max_probes) {
+        auto lit = probes[next++];
+        if (get_value(lit) == UNDEF)
+            probe_batch.push_back(lit);
+    }
+    if (probe_batch.empty())
+        return;
+
+    auto old_prober_ticks = parallel_prober.ticks;
+    parallel_prober.probe(probe_batch);
+    ticks += parallel_prober.ticks - old_prober_ticks;
+    failed_literals += parallel_prober.failed_count;
+    for (auto [lit, implied]: parallel_prober.equivalences) {
+        if (get_value(lit) == UNDEF && get_value(implied) == UNDEF)
+            add_equivalence(lit, implied);
+    }
+    // a unit may contradict a unit of another probe, then the formula is unsatisfiable and the search proves it
+    for (auto unit: parallel_prober.units) {
+        if (get_value(unit) != UNDEF)
+            continue;
+
+        set_prior_value(unit);
+        set_value(unit, reason());
+        propagate_all(true);
+        if (unsat)
+            return;
+    }
 }
 
-void solver::probe_literals() {
-    static std::vector<int> vars_order;
+// lit => x and -lit => -x, the binary clauses of lit = x are added unless they exist already
+template <typename Config>
+void solver<Config>::add_equivalence(literal lit, literal implied) {
+    auto add_missing = [this](literal first, literal second) {
+        const auto& implied = implications[first];
+        if (std::find(implied.begin(), implied.end(), second) == implied.end())
+            add_binary_clause(first, second);
+    };
+    add_missing(lit, negate(implied));
+    add_missing(negate(lit), implied);
+    equivalences++;
+}
 
-    vars_order.resize(nb_vars);
-    for (auto var = 1; var <= nb_vars; var++) {
-        vars_order[var - 1] = var;
-    }
-    std::random_shuffle(vars_order.begin(), vars_order.end());
-
-    auto start = std::chrono::steady_clock::now();
-
-    auto old_priors = priors;
-    auto var_count = 0;
-    auto changed = true;
-    while (changed) {
-        changed = false;
-        for (auto var: vars_order) {
-            auto duration = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start);
-            if (duration > probe_timeout)
-                goto end;
-
-#ifdef TRACE
-            auto milliseconds_duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
-            auto speed = (double) var_count / milliseconds_duration.count();
-            std::cout << "Performance[" << var_count << "]: \t" << speed * 1000 << " probes/sec" << std::endl;
-            var_count++;
-#endif
+// Probes a literal on the first level and leaves it assigned, unless it fails: then the negation of the UIP
+// is learnt as a unit on the root level. Long clauses implied on the first level give hyper-binary resolvents.
+template <typename Config>
+bool solver<Config>::probe(literal lit) {
+    take_snapshot(var_of(lit));
+    set_value(lit, reason());
+    propagate_all();
+    if (unsat) {
+        // all literals except the UIP are from the root level, so the learnt clause is unit
+        auto failed_lit = find_1uip_conflict_clause()[0];
+        failed_literals++;
+        backtrack();
+        set_prior_value(failed_lit);
+        set_value(failed_lit, reason());
+        propagate_all(true);
+        return false;
+    }
 
-            for (auto value: {false, true}) {
-                if (values[var] != UNDEF)
+    // the binary implication tree of the first level, a literal implied by a long clause hangs on the closest
+    // common dominator of its false literals, which implies it with a new binary clause
+    auto first = snapshots.back().trail_length;
+    probe_parents[var_of(lit)] = lit;
+    probe_depths[var_of(lit)] = 0;
+    for (auto i = first + 1; i < trail.size(); i++) {
+        auto implied = trail[i];
+        // chronological backtracking may imply root level literals here
+        if (var_to_decision_level[var_of(implied)] == 0)
+            continue;
+
+        auto implied_reason = antecedents[var_of(implied)];
+        auto parent = lit;
+        if (implied_reason.is_binary()) {
+            parent = negate(implied_reason.get_binary_literal());
+        } else {
+            const auto& c = clauses[implied_reason.get_clause()];
+            auto found = false;
+            for (uint32_t j = 1; j < c.size; j++) {
+                if (var_to_decision_level[var_of(c[j])] == 0)
                     continue;
 
-                take_snapshot(var);
-                set_value(var, value, -1);
-                propagate_all();
-                if (unsat) {
-                    auto conflict_clause = find_1uip_conflict_clause();
-                    auto best_var = std::find_if(conflict_clause.begin(), conflict_clause.end(), [this](int signed_var) {
-                        return var_to_decision_level[abs(signed_var)] == 1;
-                    });
-                    changed |= true;
-                    backtrack();
-                    set_prior_value(*best_var);
-                    set_signed_value(*best_var, -1);
-                    propagate_all(true);
-                    if (unsat)
-                        goto end;
-                } else {
-                    backtrack();
-                }
+                auto antecedent = negate(c[j]);
+                parent = found ? probe_dominator(parent, antecedent) : antecedent;
+                found = true;
             }
+            add_binary_clause(negate(parent), implied);
+            hyper_binaries++;
         }
+        probe_parents[var_of(implied)] = parent;
+        probe_depths[var_of(implied)] = probe_depths[var_of(parent)] + 1;
     }
-    end:
-    if (unsat) {
-        info("UNSAT from literals probing")
+    return true;
+}
+
+template <typename Config>
+literal solver<Config>::probe_dominator(literal a, literal b) {
+    while (a != b) {
+        if (probe_depths[var_of(a)] < probe_depths[var_of(b)])
+            std::swap(a, b);
+        a = probe_parents[var_of(a)];
     }
+    return a;
+}
+
+// Probing during search starts from the root level with a budget proportional to the ticks since the last one
+template <typename Config>
+void solver<Config>::probe_in_search() {
+    probe_interval += probe_interval_inc;
+    next_probe = conflicts + probe_interval;
+    auto budget = std::max(min_probe_ticks, (int64_t) (probe_effort * (ticks - probe_ticks)));
 
-    auto duration = std::chrono::steady_clock::now() - start;
-    info("Failed literals probing: " << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() << " ms, deduced: " << priors - old_priors)
+    backtrack_until(0);
+    propagate_all(true);
+    if (!unsat)
+        probe_literals(budget);
+    probe_ticks = ticks;
 }
 
-sat_result solver::current_result() {
+template <typename Config>
+sat_result solver<Config>::current_result() {
     if (unsat)
         return UNSAT;
 
@@ -201,443 +434,1085 @@ sat_result solver::current_result() {
     return UNKNOWN;
 }
 
-std::pair<sat_result, std::vector<int8_t>> solver::solve() {
+template <typename Config>
+std::pair<sat_result, std::vector<int8_t>> solver<Config>::solve() {
     start_time = std::chrono::steady_clock::now();
     log_time = start_time;
+    if (unsat)
+        return report_result(false);
 
-    // TODO: sort clauses with usage count along with LBD and size
-    // TODO: clause deletion while solving (before restart)
-    // TODO: get rid of implied_depth and traverse in order of trail
-    while (unsat || values_count < nb_vars) {
-        int next_var;
-        bool value;
+    while (true) {
+        propagate_all(current_decision_level() == 0);
         if (unsat) {
-            int deduced_signed_var;
-            auto decision_level = analyse_conflict(deduced_signed_var);
-            trace("Level from analyse_conflict: " << decision_level << ", current: " << current_decision_level())
-
-            if (decision_level == 0)
+            auto level = conflict_level();
+            if (level == 0)
                 return report_result(false);
 
-            backtrack_until(decision_level);
+            auto decision_level = analyse_conflict(level);
+            trace("Level from analyse_conflict: " << decision_level)
+            continue;
+        }
 
-            if (deduced_signed_var != 0) {
-                set_signed_value(deduced_signed_var, -1);
-                propagate_all(true);
-            }
+        if (values_count == nb_vars)
+            return report_result(true);
 
-            if (current_result() != UNKNOWN) {
-                return report_result(current_result());
-            }
+        if (conflicts >= next_reduce)
+            reduce_learnt_clauses();
+
+        if (conflicts >= next_rephase)
+            rephase();
+
+        if (conflicts >= next_probe) {
+            probe_in_search();
+            continue;
         }
 
-        next_var = pick_var();
-        value = pick_polarity();
-        take_snapshot(next_var);
+        if (options.local_search && conflicts >= next_walk && walk())
+            return report_result(true);
 
-        trace("Current decision level: " << current_decision_level())
-        if (!set_value(next_var, value, -1))
-            debug(debug_logic_error("Decision failed"))
-        decisions++;
+        if (restarts.should_restart())
+            restart();
 
-        propagate_all();
-        if (clauses.size() - initial_clauses_count > current_clause_limit) {
-            init(true);
-            info("Restart, new clause limit: " << current_clause_limit << ", learnt clause count: " << (clauses.size() - initial_clauses_count))
+        if (!timer_log()) {
+            std::cout << "UNKNOWN" << std::endl;
+            slow_log();
+            return std::make_pair(UNKNOWN, std::vector<int8_t>());
         }
 
-        if (!timer_log())
-            return std::make_pair(UNKNOWN, std::vector<int8_t>());
-    }
+        auto next_var = pick_var();
+        auto value = pick_polarity(next_var);
+        take_snapshot(next_var);
 
-    return report_result(true);
+        trace("Current decision level: " << current_decision_level())
+        if (!set_value(make_literal(next_var, !value), reason()) && Config::checks)
+            debug_logic_error("Decision failed")
+        decisions++;
+    }
 }
 
-std::vector<int> solver::find_1uip_conflict_clause() {
-    static std::vector<int8_t> var_count;
+template <typename Config>
+void solver<Config>::next_seen_epoch() {
+    seen_epoch++;
+    if (seen_epoch == 0) {
+        std::fill(seen_stamps.begin(), seen_stamps.end(), 0);
+        seen_epoch = 1;
+    }
+}
 
+template <typename Config>
+std::vector<literal>& solver<Config>::find_1uip_conflict_clause() {
     conflicts++;
-    if (conflict_clause >= initial_clauses_count)
-        learnt_clause_stat[conflict_clause - initial_clauses_count].used++;
-    vsids.on_conflict();
+    heuristic.on_conflict();
+    clause_activity_inc /= clause_activity_decay;
+    next_seen_epoch();
 
-    var_count.resize(nb_vars + 1);
-    std::fill(var_count.begin(), var_count.end(), 0);
-    auto new_clause = clauses[conflict_clause];
+    // the first position is reserved for the negation of the UIP
+    learnt_clause.clear();
+    learnt_clause.push_back(0);
     auto level_count = 0;
-    for (auto signed_var: new_clause) {
-        auto level = var_to_decision_level[abs(signed_var)];
-        if (level == current_decision_level())
-            level_count++;
-        var_count[abs(signed_var)]++;
-    }
+    auto add_reason_literal = [&](literal lit) {
+        auto var = var_of(lit);
+        if (seen_stamps[var] == seen_epoch)
+            return;
 
-    auto compare = [this](int left_signed_var, int right_signed_var) {
-        auto left_var = abs(left_signed_var);
-        auto right_var = abs(right_signed_var);
-        return var_implied_depth[left_var] < var_implied_depth[right_var];
+        auto level = var_to_decision_level[var];
+        if (level == 0)
+            return;
+
+        seen_stamps[var] = seen_epoch;
+        heuristic.bump(var);
+        if (level == current_decision_level()) {
+            level_count++;
+        } else {
+            learnt_clause.push_back(lit);
+        }
     };
-    std::priority_queue<int, std::vector<int>, decltype(compare)> new_clause_queue(compare);
-    for (int signed_var: new_clause) {
-        new_clause_queue.push(signed_var);
-        vsids.bump_variable(abs(signed_var));
-    }
-    new_clause.clear();
 
-    while (level_count != 1 && !new_clause_queue.empty()) {
-        auto signed_var = new_clause_queue.top();
-        auto var = abs(signed_var);
-        new_clause_queue.pop();
-        auto level = var_to_decision_level[var];
-        if (level != current_decision_level()) {
-            if (prior_values[abs(signed_var)] == UNDEF)
-                new_clause.push_back(signed_var);
-            continue;
+    auto current_reason = conflict_reason;
+    auto implied = conflict_literal;
+    auto trail_index = trail.size();
+    while (true) {
+        if constexpr (Config::checks) {
+            if (current_reason.is_undef())
+                debug_logic_error("1-UIP algorithm reached decision variable from current level")
         }
 
-        auto clause_id = antecedent_clauses[var];
-        if (clause_id >= initial_clauses_count)
-            learnt_clause_stat[clause_id - initial_clauses_count].used++;
-        debug(if (clause_id == -1)
-            debug_logic_error("1-UIP algorithm reached decision variable from current level"))
+        if (current_reason.is_binary()) {
+            add_reason_literal(implied);
+            add_reason_literal(current_reason.get_binary_literal());
+        } else {
+            auto& c = clauses[current_reason.get_clause()];
+            ticks++;
+            if (c.learnt) {
+                c.used++;
+                bump_clause(c);
+                // clauses get closer to glue as the search goes on, promote them to a more durable tier
+                if (c.tier != CORE) {
+                    auto lbd = compute_lbd(c.begin(), c.end());
+                    if (lbd < c.lbd) {
+                        c.lbd = lbd;
+                        if (lbd <= core_lbd_limit) {
+                            c.tier = CORE;
+                        } else if (lbd <= tier2_lbd_limit) {
+                            c.tier = TIER2;
+                        }
+                    }
+                }
+            }
+            for (auto lit: c) {
+                add_reason_literal(lit);
+            }
+        }
 
+        // walk the trail back to the next marked variable of the current level, lower levels may be interleaved with it
+        do {
+            trail_index--;
+        } while (seen_stamps[var_of(trail[trail_index])] != seen_epoch
+                 || var_to_decision_level[var_of(trail[trail_index])] != current_decision_level());
+        implied = trail[trail_index];
         level_count--;
-        for (auto other_signed_var: clauses[clause_id]) {
-            if (abs(other_signed_var) == var || var_count[abs(other_signed_var)] > 0)
-                continue;
+        if (level_count == 0)
+            break;
 
-            auto other_level = var_to_decision_level[abs(other_signed_var)];
-            new_clause_queue.push(other_signed_var);
-            vsids.bump_variable(abs(other_signed_var));
-            if (other_level == current_decision_level())
-                level_count++;
-            var_count[abs(other_signed_var)]++;
-        }
+        current_reason = antecedents[var_of(implied)];
     }
-    while (!new_clause_queue.empty()) {
-        if (prior_values[abs(new_clause_queue.top())] == UNDEF)
-            new_clause.push_back(new_clause_queue.top());
-        new_clause_queue.pop();
+    learnt_clause[0] = negate(implied);
+
+    return learnt_clause;
+}
+
+template <typename Config>
+void solver<Config>::minimize_learnt_clause() {
+    // marks of redundant variables expire with the epoch, only failed checks reset theirs
+    minimize_to_clear.clear();
+    uint32_t abstract_levels = 0;
+    for (auto i = 1; i < learnt_clause.size(); i++) {
+        abstract_levels |= abstract_level(var_of(learnt_clause[i]));
     }
 
-    return new_clause;
+    auto old_size = learnt_clause.size();
+    auto write = 1;
+    for (auto read = 1; read < learnt_clause.size(); read++) {
+        auto lit = learnt_clause[read];
+        if (antecedents[var_of(lit)].is_undef() || !is_redundant(lit, abstract_levels))
+            learnt_clause[write++] = lit;
+    }
+    learnt_clause.resize(write);
+
+    learnt_count++;
+    minimized_literals += old_size - learnt_clause.size();
+    learnt_literals += learnt_clause.size();
 }
 
-int solver::analyse_conflict(int& deduced_signed_var) {
-    auto new_clause = find_1uip_conflict_clause();
-    deduced_signed_var = 0;
+// Checks if the literal is implied by other literals of the learnt clause, i.e. if all paths
+// through its reasons end in marked variables. Variables proven to be redundant stay marked.
+template <typename Config>
+bool solver<Config>::is_redundant(literal lit, uint32_t abstract_levels) {
+    minimize_stack.clear();
+    minimize_stack.push_back(lit);
+    auto clear_top = minimize_to_clear.size();
+
+    while (!minimize_stack.empty()) {
+        auto current = minimize_stack.back();
+        minimize_stack.pop_back();
+
+        auto failed = false;
+        auto visit = [&](literal other) {
+            auto var = var_of(other);
+            if (seen_stamps[var] == seen_epoch || var_to_decision_level[var] == 0)
+                return;
 
-    if (new_clause.empty()) {
-        return 0;
+            // variables from levels absent in the clause can't be implied by it
+            if (antecedents[var].is_undef() || (abstract_level(var) & abstract_levels) == 0) {
+                failed = true;
+                return;
+            }
+            seen_stamps[var] = seen_epoch;
+            minimize_stack.push_back(other);
+            minimize_to_clear.push_back(var);
+        };
+
+        auto current_reason = antecedents[var_of(current)];
+        if (current_reason.is_binary()) {
+            visit(current_reason.get_binary_literal());
+        } else {
+            for (auto other: clauses[current_reason.get_clause()]) {
+                if (var_of(other) != var_of(current) && !failed)
+                    visit(other);
+            }
+        }
+
+        if (failed) {
+            for (auto i = clear_top; i < minimize_to_clear.size(); i++) {
+                seen_stamps[minimize_to_clear[i]] = 0;
+            }
+            minimize_to_clear.resize(clear_top);
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Config>
+uint32_t solver<Config>::abstract_level(uint32_t var) {
+    return 1u << (var_to_decision_level[var] & 31);
+}
+
+// Highest level among literals of the conflicting clause. It is always the current level,
+// unless chronological backtracking left lower levels above it on the trail.
+template <typename Config>
+int solver<Config>::conflict_level() {
+    if constexpr (!Config::chrono_backtrack)
+        return current_decision_level();
+
+    if (conflict_reason.is_binary()) {
+        return std::max(var_to_decision_level[var_of(conflict_literal)],
+                        var_to_decision_level[var_of(conflict_reason.get_binary_literal())]);
+    }
+    auto level = 0;
+    for (auto lit: clauses[conflict_reason.get_clause()]) {
+        level = std::max(level, var_to_decision_level[var_of(lit)]);
     }
+    return level;
+}
+
+// Conflict below the current level: backtracks to it and analyses it as usual. If the conflicting clause has
+// a single literal on that level, the clause is unit one level lower and the literal is implied without learning.
+template <typename Config>
+bool solver<Config>::analyse_lower_conflict(int level) {
+    lower_conflicts++;
+    auto saved_reason = conflict_reason;
+    auto saved_literal = conflict_literal;
+
+    if (saved_reason.is_binary()) {
+        auto other = saved_reason.get_binary_literal();
+        auto conflict_on_level = var_to_decision_level[var_of(saved_literal)] == level;
+        auto other_on_level = var_to_decision_level[var_of(other)] == level;
+        if (conflict_on_level != other_on_level) {
+            backtrack_until(level - 1);
+            if (conflict_on_level) {
+                set_value(saved_literal, reason::binary(other));
+            } else {
+                set_value(other, reason::binary(saved_literal));
+            }
+            return true;
+        }
+    } else {
+        auto cref = saved_reason.get_clause();
+        auto& c = clauses[cref];
+        auto forced_index = c.size;
+        auto count = 0;
+        for (uint32_t i = 0; i < c.size; i++) {
+            if (var_to_decision_level[var_of(c[i])] == level) {
+                forced_index = i;
+                count++;
+            }
+        }
+        if (count == 1) {
+            // the implied literal goes first and the highest of the rest second, both of them are watched
+            auto old_first = c[0];
+            auto old_second = c[1];
+            std::swap(c[0], c[forced_index]);
+            auto highest = 1;
+            for (uint32_t i = 2; i < c.size; i++) {
+                if (var_to_decision_level[var_of(c[i])] > var_to_decision_level[var_of(c[highest])])
+                    highest = i;
+            }
+            std::swap(c[1], c[highest]);
+            for (auto old_watch: {old_first, old_second}) {
+                if (old_watch != c[0] && old_watch != c[1]) {
+                    auto& old_watches = watches[old_watch];
+                    old_watches.erase(std::find_if(old_watches.begin(), old_watches.end(),
+                                                   [cref](const watcher& w) { return w.cref == cref; }));
+                }
+            }
+            for (auto i = 0; i < 2; i++) {
+                if (c[i] != old_first && c[i] != old_second)
+                    watches[c[i]].push_back({cref, c[1 - i]});
+            }
+            backtrack_until(level - 1);
+            set_value(c[0], saved_reason);
+            return true;
+        }
+    }
+
+    backtrack_until(level);
+    unsat = true;
+    conflict_reason = saved_reason;
+    conflict_literal = saved_literal;
+    return false;
+}
+
+template <typename Config>
+int solver<Config>::analyse_conflict(int level) {
+    if (level < current_decision_level() && analyse_lower_conflict(level))
+        return level - 1;
+
+    auto& new_clause = find_1uip_conflict_clause();
+    minimize_learnt_clause();
+    auto lbd = compute_lbd(new_clause.data(), new_clause.data() + new_clause.size());
+    restarts.on_conflict(lbd);
 
     if (new_clause.size() == 1) {
+        backtrack_until(0);
         set_prior_value(new_clause[0]);
-        deduced_signed_var = new_clause[0];
-        return 1;
+        set_value(new_clause[0], reason());
+        return 0;
+    }
+
+    // the literal with the highest level goes to the second position, so it is watched
+    auto max_index = 1;
+    for (auto i = 2; i < new_clause.size(); i++) {
+        if (var_to_decision_level[var_of(new_clause[i])] > var_to_decision_level[var_of(new_clause[max_index])])
+            max_index = i;
+    }
+    std::swap(new_clause[1], new_clause[max_index]);
+    auto next_level = var_to_decision_level[var_of(new_clause[1])];
+
+    // everything below the conflict level is consistent
+    update_phases(snapshots.back().trail_length);
+
+    // long jumps undo assignments that are mostly propagated again, backtrack chronologically instead
+    auto backtrack_level = next_level;
+    if (Config::chrono_backtrack && current_decision_level() - next_level > options.chrono_distance) {
+        backtrack_level = current_decision_level() - 1;
+        chrono_backtracks++;
+    }
+
+    auto learnt_reason = add_clause(new_clause, lbd);
+    backtrack_until(backtrack_level);
+    set_value(new_clause[0], learnt_reason);
+
+    return backtrack_level;
+}
+
+template <typename Config>
+void solver<Config>::bump_clause(clause& c) {
+    c.activity += (float) clause_activity_inc;
+    if (c.activity > 1e20) {
+        for (auto cref: learnt_clauses) {
+            clauses[cref].activity *= 1e-20;
+        }
+        clause_activity_inc *= 1e-20;
+    }
+}
+
+// Number of distinct non-root decision levels among the literals
+template <typename Config>
+uint32_t solver<Config>::compute_lbd(const literal* begin, const literal* end) {
+    level_epoch++;
+    if (level_epoch == 0) {
+        std::fill(level_stamps.begin(), level_stamps.end(), 0);
+        level_epoch = 1;
+    }
+
+    uint32_t lbd = 0;
+    for (auto it = begin; it != end; it++) {
+        auto level = var_to_decision_level[var_of(*it)];
+        if (level == 0 || level_stamps[level] == level_epoch)
+            continue;
+
+        level_stamps[level] = level_epoch;
+        lbd++;
+    }
+    return lbd;
+}
+
+template <typename Config>
+void solver<Config>::reduce_learnt_clauses() {
+    reductions++;
+
+    reduce_candidates.clear();
+    for (auto cref: learnt_clauses) {
+        auto& c = clauses[cref];
+        if (c.tier == LOCAL) {
+            if (!is_locked(cref))
+                reduce_candidates.push_back(cref);
+        } else if (c.tier == TIER2 && c.used == 0) {
+            // not used since the last reduction, so it competes with local clauses from now on
+            c.tier = LOCAL;
+        }
+        c.used = 0;
     }
 
-    auto max = -1;
-    for (auto signed_var: new_clause) {
-        auto level = var_to_decision_level[abs(signed_var)];
-        if (level == current_decision_level())
+    std::sort(reduce_candidates.begin(), reduce_candidates.end(), [this](clause_ref left, clause_ref right) {
+        return clauses[left].activity < clauses[right].activity;
+    });
+    auto remove_count = (size_t) (reduce_candidates.size() * local_reduce_ratio);
+    for (size_t i = 0; i < remove_count; i++) {
+        remove_clause(reduce_candidates[i]);
+    }
+    reduced_clauses += remove_count;
+    subsume_learnt_clauses();
+
+    learnt_clauses.erase(std::remove_if(learnt_clauses.begin(), learnt_clauses.end(), [this](clause_ref cref) {
+        return clauses[cref].removed;
+    }), learnt_clauses.end());
+    for (auto& watch_list: watches) {
+        watch_list.erase(std::remove_if(watch_list.begin(), watch_list.end(), [this](const watcher& w) {
+            return clauses[w.cref].removed;
+        }), watch_list.end());
+    }
+
+    if (clauses.wasted_words() > clauses.size_words() * garbage_ratio)
+        collect_garbage();
+
+    reduce_interval += reduce_interval_inc;
+    next_reduce = conflicts + reduce_interval;
+    select_propagation();
+    info("Reduce learnt clauses: removed " << remove_count << ", learnt clause count: " << learnt_clauses.size())
+}
+
+// Removes learnt clauses subsumed by other learnt clauses with a budget proportional to the ticks since
+// the last time. Clauses are not strengthened, since a shorter clause doesn't fit in place in the arena.
+// A clause is subsumed only by one at most as long and the checks go from the shortest clause, so only the
+// shortest clauses whose literals fit in the budget are copied. Small budgets are saved up for a later run.
+template <typename Config>
+void solver<Config>::subsume_learnt_clauses() {
+    auto budget = (int64_t) (subsume_effort * (ticks - subsume_ticks));
+    if (budget < min_subsume_ticks)
+        return;
+
+    subsume_size_literals.clear();
+    for (auto cref: learnt_clauses) {
+        const auto& c = clauses[cref];
+        if (c.removed)
             continue;
 
-        if (level > max)
-            max = level;
+        if (c.size >= subsume_size_literals.size())
+            subsume_size_literals.resize(c.size + 1, 0);
+        subsume_size_literals[c.size] += c.size;
+    }
+    uint32_t size_limit = 0;
+    int64_t copied_literals = 0;
+    while (size_limit + 1 < subsume_size_literals.size()
+           && copied_literals + subsume_size_literals[size_limit + 1] <= budget) {
+        size_limit++;
+        copied_literals += subsume_size_literals[size_limit];
+    }
+
+    subsume_refs.clear();
+    for (auto cref: learnt_clauses) {
+        const auto& c = clauses[cref];
+        if (!c.removed && c.size <= size_limit)
+            subsume_refs.push_back(cref);
+    }
+    subsume_clauses.resize(subsume_refs.size());
+    for (size_t i = 0; i < subsume_refs.size(); i++) {
+        const auto& c = clauses[subsume_refs[i]];
+        subsume_clauses[i].assign(c.begin(), c.end());
+    }
+
+    auto start_ticks = subsumer.ticks;
+    subsumer.run(subsume_clauses, nb_vars, false, budget, [this](uint32_t subsumed, uint32_t subsuming) {
+        auto cref = subsume_refs[subsumed];
+        if (is_locked(cref))
+            return;
+
+        // the subsuming clause takes the better tier
+        auto& kept = clauses[subsume_refs[subsuming]];
+        if constexpr (Config::checks) {
+            for (auto lit: kept) {
+                if (std::find(clauses[cref].begin(), clauses[cref].end(), lit) == clauses[cref].end())
+                    debug_logic_error("Clause is not subsumed: " << cref)
+            }
+        }
+        kept.tier = std::min<uint32_t>(kept.tier, clauses[cref].tier);
+        remove_clause(cref);
+        subsumed_clauses++;
+    });
+    ticks += subsumer.ticks - start_ticks;
+    subsume_ticks = ticks;
+}
+
+// Reason clauses of current assignments can't be removed, the implied literal is always the first one
+template <typename Config>
+bool solver<Config>::is_locked(clause_ref cref) {
+    auto lit = clauses[cref][0];
+    const auto& lit_reason = antecedents[var_of(lit)];
+    return get_value(lit) == TRUE && lit_reason.is_clause() && lit_reason.get_clause() == cref;
+}
+
+template <typename Config>
+void solver<Config>::remove_clause(clause_ref cref) {
+    if constexpr (Config::checks) {
+        clause_filter.erase(filter_key(clauses[cref].begin(), clauses[cref].end()));
+    }
+    clauses.free(cref);
+}
+
+// Compacts learnt clauses in the arena and updates watchers and reasons which refer to moved clauses.
+// Watchers of removed clauses must be dropped before.
+template <typename Config>
+void solver<Config>::collect_garbage() {
+    garbage_collections++;
+
+    relocations.clear();
+    learnt_clauses.clear();
+    clauses.compact(learnt_clauses_start, [this](clause_ref old_ref, clause_ref new_ref) {
+        relocations.emplace_back(old_ref, new_ref);
+        learnt_clauses.push_back(new_ref);
+    });
+
+    // relocations are sorted by old reference, since compaction preserves the order of clauses
+    auto relocate = [this](clause_ref cref) {
+        if (cref < learnt_clauses_start)
+            return cref;
+
+        auto it = std::lower_bound(relocations.begin(), relocations.end(), std::make_pair(cref, (clause_ref) 0));
+        if constexpr (Config::checks) {
+            if (it == relocations.end() || it->first != cref)
+                debug_logic_error("Reference to removed clause: " << cref)
+        }
+        return it->second;
+    };
+
+    for (auto& watch_list: watches) {
+        for (auto& w: watch_list) {
+            w.cref = relocate(w.cref);
+        }
+    }
+    for (auto lit: trail) {
+        auto& lit_reason = antecedents[var_of(lit)];
+        if (lit_reason.is_clause())
+            lit_reason = reason::long_clause(relocate(lit_reason.get_clause()));
+    }
+}
+
+// Backtracks to the lowest level, which is not reused: decisions on lower levels would be
+// made again right after the restart, since the heuristic prefers their variables to the next decision
+template <typename Config>
+void solver<Config>::restart() {
+    restart_count++;
+    restarts.on_restart();
+
+    auto next_var = heuristic.pick();
+    auto level = 0;
+    while (level < current_decision_level() && heuristic.prefers(snapshots[level + 1].next_var, next_var)) {
+        level++;
     }
+    reused_levels += level;
+    target_assigned = 0;
 
-    debug(if (max == -1)
-        debug_logic_error("All vars from current decision level and size of clause is not 1 => not a UIP clause"))
+    trace("Restart, reused levels: " << level << " of " << current_decision_level())
+    backtrack_until(level);
+}
 
-    auto next_level = max;
-    add_clause(new_clause, next_level);
+// Runs local search from the current trail with a budget of ticks proportional to the ticks since the last walk.
+// The best assignment becomes the saved phases, if it satisfies all clauses, it is assigned on the first level.
+template <typename Config>
+bool solver<Config>::walk() {
+    walk_count++;
+    walk_interval += walk_interval_inc;
+    next_walk = conflicts + walk_interval;
+    auto budget = std::max(min_walk_ticks, (int64_t) (options.local_search_effort * (ticks - walk_ticks)));
+
+    // unassigned variables save the values of the trail as their phases, the walk starts from them
+    backtrack_until(0);
+    auto old_walker_ticks = walker.ticks;
+    auto satisfied = walker.run(random, budget, saved_phases);
+    ticks += walker.ticks - old_walker_ticks;
+    walk_ticks = ticks;
+    std::fill(target_phases.begin(), target_phases.end(), UNDEF);
+    target_assigned = 0;
+    trace("Walk: " << (satisfied ? "satisfied" : "not satisfied") << " with " << budget << " ticks")
+    if (!satisfied)
+        return false;
 
-    return next_level;
+    take_snapshot(0);
+    for (auto var = 1; var <= nb_vars; var++) {
+        if (values[make_literal(var, false)] == UNDEF)
+            set_value(make_literal(var, saved_phases[var] == FALSE), reason());
+    }
+    return true;
 }
 
-bool solver::pick_polarity() {
-    std::default_random_engine rd((uint32_t) time(0));
-    std::uniform_int_distribution<int> coin(0, 1);
+template <typename Config>
+bool solver<Config>::pick_polarity(int var) {
+    if (!options.phase_saving)
+        return initial_polarity();
 
-    switch (pick_polarity_mode) {
+    if (options.target_phases && target_phases[var] != UNDEF)
+        return target_phases[var] == TRUE;
+    return saved_phases[var] == TRUE;
+}
+
+template <typename Config>
+bool solver<Config>::initial_polarity() {
+    switch (options.polarity) {
         case polarity_mode::TRUE:
             return true;
         case polarity_mode::FALSE:
             return false;
         case polarity_mode::RANDOM:
-            return coin(rd) == 1;
+            return random.next_bool();
+    }
+    return false;
+}
+
+// Remembers values of the first `trail_length` assigned literals if they form the longest
+// conflict-free trail since the last restart (target) or since the last rephase (best)
+template <typename Config>
+void solver<Config>::update_phases(size_t trail_length) {
+    if (trail_length > target_assigned) {
+        target_assigned = trail_length;
+        for (size_t i = 0; i < trail_length; i++) {
+            target_phases[var_of(trail[i])] = is_negative(trail[i]) ? FALSE : TRUE;
+        }
+    }
+    if (trail_length > best_assigned) {
+        best_assigned = trail_length;
+        for (size_t i = 0; i < trail_length; i++) {
+            best_phases[var_of(trail[i])] = is_negative(trail[i]) ? FALSE : TRUE;
+        }
     }
 }
 
-int solver::pick_var() {
-    static std::default_random_engine rd((uint32_t) time(0));
-    static std::uniform_real_distribution<double> dist(0.0, 1.0);
+// Resets saved phases, cycling through original, inverted, best and random ones
+template <typename Config>
+void solver<Config>::rephase() {
+    auto kind = rephase_count % 4;
+    rephase_count++;
+    rephase_interval += rephase_interval_inc;
+    next_rephase = conflicts + rephase_interval;
+
+    for (auto var = 1; var <= nb_vars; var++) {
+        switch (kind) {
+            case 0:
+                saved_phases[var] = initial_polarity() ? TRUE : FALSE;
+                break;
+            case 1:
+                saved_phases[var] = initial_polarity() ? FALSE : TRUE;
+                break;
+            case 2:
+                if (best_phases[var] != UNDEF)
+                    saved_phases[var] = best_phases[var];
+                break;
+            case 3:
+                saved_phases[var] = random.next_bool() ? TRUE : FALSE;
+                break;
+        }
+    }
+    if (kind == 2)
+        best_assigned = 0;
+
+    // target phases would override the new ones right away
+    std::fill(target_phases.begin(), target_phases.end(), UNDEF);
+    target_assigned = 0;
+    trace("Rephase: " << kind)
+}
 
+template <typename Config>
+int solver<Config>::pick_var() {
     auto var = 0;
-    if (dist(rd) < random_pick_var_prob) {
+    if (random.next_double() < random_pick_var_prob) {
         trace("Pick var using random")
         var = pick_var_random();
     } else {
-        trace("Pick var using VSIDS")
-        var = vsids.pick();
+        trace("Pick var using decision heuristic")
+        var = heuristic.pick();
     }
 
     trace("Pick variable: " << var)
     return var;
 }
 
-int solver::pick_var_random() {
-    static std::default_random_engine rd((uint32_t) time(0));
-
-    std::uniform_int_distribution<size_t> dist(1, nb_vars - values_count);
-    auto index = dist(rd);
-    auto counter = 0;
-    for (auto var = 1; var <= nb_vars; var++) {
-        if (values[var] == UNDEF) {
-            counter++;
-            if (counter == index)
-                return var;
-        }
-    }
+template <typename Config>
+int solver<Config>::pick_var_random() {
+    return unassigned_vars.pick_random(random);
+}
 
-    debug(debug_logic_error("Failed to pick a random variable"))
+template <typename Config>
+void solver<Config>::take_snapshot(int next_var) {
+    snapshots.push_back({next_var, trail.size()});
 }
 
-void solver::take_snapshot(int next_var) {
-    snapshots.push_back({next_var, values_stack.size()});
+template <typename Config>
+void solver<Config>::backtrack() {
+    if constexpr (Config::checks) {
+        if (snapshots.empty())
+            debug_logic_error("Tried to backtrack with empty stack")
+    }
+
+    backtrack_until(current_decision_level() - 1);
 }
 
-void solver::backtrack() {
-    debug(if (snapshots.empty())
-        debug_logic_error("Tried to backtrack with empty stack"))
+// Unassigns all levels above the given one at once. With chronological backtracking the trail may hold
+// literals of lower levels above the start of a removed level, they stay on the trail and are propagated again
+template <typename Config>
+void solver<Config>::backtrack_until(int decision_level) {
+    if (current_decision_level() <= decision_level)
+        return;
 
-    auto snapshot = snapshots.back();
-    snapshots.pop_back();
+    auto level_start = snapshots[decision_level + 1].trail_length;
+    snapshots.resize(decision_level + 1);
     unsat = false;
-    conflict_clause = -1;
+    conflict_reason = reason();
 
-    for (auto i = snapshot.values_stack_length; i < values_stack.size(); i++) {
-        unset_value(values_stack[i]);
+    auto write = level_start;
+    for (auto read = level_start; read < trail.size(); read++) {
+        auto lit = trail[read];
+        if (var_to_decision_level[var_of(lit)] > decision_level) {
+            unset_value(var_of(lit));
+        } else {
+            trail[write++] = lit;
+        }
     }
-    values_stack.resize(snapshot.values_stack_length);
-}
-
-void solver::backtrack_until(int decision_level) {
-    do {
-        backtrack();
-    } while (current_decision_level() >= decision_level);
+    trail.resize(write);
+    binary_propagation_head = level_start;
+    propagation_head = level_start;
 }
 
-int solver::current_decision_level() {
+template <typename Config>
+int solver<Config>::current_decision_level() {
     return (int) snapshots.size() - 1;
 }
 
-void solver::propagate_all(bool prior) {
-    while (!propagation_queue.empty()) {
+template <typename Config>
+void solver<Config>::propagate_all(bool prior) {
+    while (propagation_head < trail.size() && !unsat) {
+        // binary implications of the whole trail are propagated before any long clause
+        while (binary_propagation_head < trail.size() && !unsat) {
+            propagate_binary(trail[binary_propagation_head++], prior);
+        }
         if (unsat)
             break;
 
-        auto var = propagation_queue.front();
-        propagation_queue.pop();
-        propagate_var(var, prior);
+        propagate_literal(trail[propagation_head++], prior);
         propagations++;
     }
-    while (!propagation_queue.empty()) {
-        propagation_queue.pop();
+}
+
+template <typename Config>
+void solver<Config>::propagate_binary(literal lit, bool prior) {
+    auto false_lit = negate(lit);
+    ticks++;
+    for (auto implied: implications[false_lit]) {
+        auto implied_value = get_value(implied);
+        if (implied_value == TRUE)
+            continue;
+
+        if (implied_value == FALSE) {
+            unsat = true;
+            conflict_reason = reason::binary(false_lit);
+            conflict_literal = implied;
+            return;
+        }
+        set_value(implied, reason::binary(false_lit));
+        if (prior) {
+            set_prior_value(implied);
+        }
     }
 }
 
-void solver::propagate_var(int var, bool prior) {
-    auto ever_found = false;
-    auto signed_self = values[var] == FALSE ? var : -var;
-    auto& watch_clauses = signed_self > 0
-            ? pos_var_to_watch_clauses[var]
-            : neg_var_to_watch_clauses[var];
+// Prefetching pays off only if clauses are mostly missed in the cache, in AUTO mode it is turned on once the clause
+// arena takes more than half of the last level cache, the rest is roughly the size of watch lists and other state.
+// Batches cost about a fifth of propagation speed on instances that fit into the cache.
+template <typename Config>
+void solver<Config>::select_propagation() {
+    if (options.propagation != propagation_mode::AUTO) {
+        prefetch_watches = options.propagation == propagation_mode::PREFETCH;
+        return;
+    }
 
-    for (auto clause_id: watch_clauses) {
-        auto signed_other = watch_vars[clause_id].first == signed_self
-                ? watch_vars[clause_id].second
-                : watch_vars[clause_id].first;
+    static const auto cache_size = []() -> size_t {
+#ifdef _SC_LEVEL3_CACHE_SIZE
+        auto size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        if (size > 0)
+            return (size_t) size;
+#endif
+        return default_cache_size;
+    }();
+    prefetch_watches = 2 * clauses.size_words() * sizeof(uint32_t) > cache_size;
+}
 
-        auto found = false;
-        for (auto signed_candidate_var: clauses[clause_id]) {
-            if (signed_candidate_var == signed_other ||
-                signed_candidate_var == signed_self ||
-                get_signed_value(signed_candidate_var) == FALSE)
-                continue;
+template <typename Config>
+void solver<Config>::propagate_literal(literal lit, bool prior) {
+    if (prefetch_watches) {
+        propagate_watches<true>(lit, prior);
+    } else {
+        propagate_watches<false>(lit, prior);
+    }
+}
 
-            found = true;
-            replace_watch_var(watch_clauses, clause_id, signed_other, signed_candidate_var);
-            break;
+// With prefetching the watch list is processed in batches: values of blockers are prefetched two batches ahead
+// and clauses one batch ahead, so their loads overlap with the evaluation of the current batch.
+// The order of processed watchers is the same in both modes.
+template <typename Config>
+template <bool prefetch>
+void solver<Config>::propagate_watches(literal lit, bool prior) {
+    auto false_lit = negate(lit);
+    auto& watch_clauses = watches[false_lit];
+
+    watcher* read = watch_clauses.data();
+    watcher* write = read;
+    watcher* end = read + watch_clauses.size();
+    watcher* batch_end = read;
+    auto ahead = [&](size_t distance) {
+        return (size_t) (end - read) > distance ? read + distance : end;
+    };
+    if constexpr (prefetch) {
+        prefetch_blockers(read, ahead(2 * prefetch_batch));
+        prefetch_clauses(read, ahead(prefetch_batch));
+    }
+    ticks++;
+    while (read != end) {
+        if constexpr (prefetch) {
+            if (read == batch_end) {
+                batch_end = ahead(prefetch_batch);
+                prefetch_clauses(batch_end, ahead(2 * prefetch_batch));
+                prefetch_blockers(ahead(2 * prefetch_batch), ahead(3 * prefetch_batch));
+            }
         }
-        ever_found |= found;
-        if (!found) {
-            if (get_signed_value(signed_other) == FALSE) {
-                unsat = true;
-                conflict_clause = clause_id;
-                watch_clauses.erase(
-                        std::remove(watch_clauses.begin(), watch_clauses.end(), -1),
-                        watch_clauses.end()
-                );
-                return;
+
+        // fast path: clause is already satisfied by the blocker literal
+        if (get_value(read->blocker) == TRUE) {
+            *write++ = *read++;
+            continue;
+        }
+
+        auto cref = read->cref;
+        auto& c = clauses[cref];
+        ticks++;
+        if (c[0] == false_lit)
+            std::swap(c[0], c[1]);
+        read++;
+
+        // the false literal is now at position 1, check if the other watch satisfies the clause
+        auto other = c[0];
+        watcher updated {cref, other};
+        if (get_value(other) == TRUE) {
+            *write++ = updated;
+            continue;
+        }
+
+        auto replacement = c.size;
+        if (c.size <= long_clause_size) {
+            for (uint32_t i = 2; i < c.size; i++) {
+                if (get_value(c[i]) != FALSE) {
+                    replacement = i;
+                    break;
+                }
             }
-            set_signed_value(signed_other, clause_id);
-            if (prior) {
-                set_prior_value(signed_other);
+        } else {
+            // search long clauses circularly from the last replacement, so false prefixes are not rescanned
+            auto start = c.search_pos < c.size ? c.search_pos : 2;
+            replacement = find_non_false(values.data(), c.begin(), start, c.size);
+            auto scanned = replacement - start;
+            if (replacement == c.size) {
+                replacement = find_non_false(values.data(), c.begin(), 2, start);
+                scanned += replacement - 2;
+                if (replacement == start)
+                    replacement = c.size;
             }
+            ticks += scanned / literals_per_tick;
+            if (replacement != c.size)
+                c.search_pos = replacement;
+        }
+        if (replacement != c.size) {
+            c[1] = c[replacement];
+            c[replacement] = false_lit;
+            watches[c[1]].push_back(updated);
+            continue;
+        }
+
+        // clause is unit or conflicting, keep watching it
+        *write++ = updated;
+        if (get_value(other) == FALSE) {
+            unsat = true;
+            conflict_reason = reason::long_clause(cref);
+            while (read != end) {
+                *write++ = *read++;
+            }
+            break;
+        }
+        // with out-of-order levels the second watch must stay false as long as the implied literal is assigned
+        if (Config::chrono_backtrack && watch_highest_level(cref))
+            write--;
+        set_value(other, reason::long_clause(cref));
+        if (prior) {
+            set_prior_value(other);
         }
     }
-    if (ever_found) {
-        watch_clauses.erase(
-                std::remove(watch_clauses.begin(), watch_clauses.end(), -1),
-                watch_clauses.end()
-        );
-    }
+    watch_clauses.resize(write - watch_clauses.data());
 }
 
-void solver::replace_watch_var(std::vector<int>& from_watch_clauses, int clause_id, int signed_other_var, int signed_to_var) {
-    auto position = std::find(from_watch_clauses.begin(), from_watch_clauses.end(), clause_id);
-    debug(if (position == from_watch_clauses.end())
-        debug_logic_error("from_var was not a watch literal for clause_id: " << clause_id))
+template <typename Config>
+void solver<Config>::prefetch_blockers(const watcher* begin, const watcher* end) {
+    for (auto it = begin; it != end; it++) {
+        __builtin_prefetch(&values[it->blocker]);
+    }
+}
 
-    *position = -1;
-    watch_vars[clause_id] = std::make_pair(signed_other_var, signed_to_var);
-    if (signed_to_var > 0) {
-        pos_var_to_watch_clauses[signed_to_var].push_back(clause_id);
-    } else {
-        neg_var_to_watch_clauses[-signed_to_var].push_back(clause_id);
+// Clauses are prefetched even if their blocker is true, a branch on the blocker value here costs more than the
+// wasted loads. The header and both watched literals of a clause may span two cache lines.
+template <typename Config>
+void solver<Config>::prefetch_clauses(const watcher* begin, const watcher* end) {
+    for (auto it = begin; it != end; it++) {
+        const auto& c = clauses[it->cref];
+        __builtin_prefetch(&c);
+        __builtin_prefetch(c.begin() + 1);
     }
 }
 
-void solver::apply_prior_values() {
+template <typename Config>
+void solver<Config>::watch_clause(clause_ref cref) {
+    const auto& c = clauses[cref];
+    watches[c[0]].push_back({cref, c[1]});
+    watches[c[1]].push_back({cref, c[0]});
+}
+
+template <typename Config>
+void solver<Config>::add_binary_clause(literal first, literal second) {
+    implications[first].push_back(second);
+    implications[second].push_back(first);
+    probe_dirty[var_of(first)] = true;
+    probe_dirty[var_of(second)] = true;
+}
+
+template <typename Config>
+void solver<Config>::apply_prior_values() {
     for (auto var = 1; var <= nb_vars; var++) {
         if (prior_values[var] != UNDEF)
-            set_value(var, prior_values[var], -1);
+            set_value(make_literal(var, prior_values[var] == FALSE), reason());
     }
     propagate_all(true);
 }
 
-bool solver::set_value(int var, bool value, int reason_clause) {
+template <typename Config>
+bool solver<Config>::set_value(literal lit, reason reason) {
     if (unsat)
         return false;
 
-    if (values[var] == UNDEF) {
-        values[var] = value ? TRUE : FALSE;
+    auto var = var_of(lit);
+    if (values[lit] == UNDEF) {
+        values[lit] = TRUE;
+        values[negate(lit)] = FALSE;
         values_count++;
-        values_stack.push_back(var);
-        antecedent_clauses[var] = reason_clause;
-        auto implied_depth = 0;
-        if (reason_clause != -1) {
-            for (int signed_var: clauses[reason_clause]) {
-                if (var_to_decision_level[abs(signed_var)] != current_decision_level())
-                    continue;
-
-                implied_depth = std::max(implied_depth, var_implied_depth[abs(signed_var)] + 1);
-            }
-        }
-        var_implied_depth[var] = implied_depth;
-        var_to_decision_level[var] = current_decision_level();
-        propagation_queue.push(var);
+        unassigned_vars.remove(var);
+        trail.push_back(lit);
+        antecedents[var] = reason;
+        var_to_decision_level[var] = Config::chrono_backtrack && !reason.is_undef()
+                                     ? reason_level(reason) : current_decision_level();
+        heuristic.on_var_assign(var);
         return true;
     }
-    debug(if (values[var] != value)
-        debug_logic_error("Tried to reassign variable " << var << ": old value was " << values[var] << ", new value was " << value))
+    if constexpr (Config::checks) {
+        if (values[lit] != TRUE)
+            debug_logic_error("Tried to reassign variable " << var << ": old value was " << values[make_literal(var, false)] << ", new value was " << !is_negative(lit))
+    }
     return false;
 }
 
-void solver::unset_value(int var) {
-    debug(if (get_signed_value(var) == UNDEF)
-        debug_logic_error("Trying to unset already undefined var: " << var))
+// Highest level of the false literals of a reason, the implied literal is assigned on it and may be below the current level
+template <typename Config>
+int solver<Config>::reason_level(reason reason) {
+    if (reason.is_binary())
+        return var_to_decision_level[var_of(reason.get_binary_literal())];
 
-    values[var] = UNDEF;
-    antecedent_clauses[var] = -1;
-    var_implied_depth[var] = 0;
-    values_count--;
-    vsids.on_var_unset(var);
+    // the second literal of a reason clause is the one with the highest level
+    return var_to_decision_level[var_of(clauses[reason.get_clause()][1])];
 }
 
-void solver::set_prior_value(int signed_var) {
-    if (prior_values[abs(signed_var)] == UNDEF)
-        priors++;
-
-    prior_values[abs(signed_var)] = signed_var > 0 ? TRUE : FALSE;
-}
+// Moves the second watch of a unit clause to its false literal with the highest level, the new watcher is added
+// to the list of that literal. Returns false if the second watch already has the highest level.
+template <typename Config>
+bool solver<Config>::watch_highest_level(clause_ref cref) {
+    auto& c = clauses[cref];
+    auto highest = 1;
+    for (uint32_t i = 2; i < c.size; i++) {
+        if (var_to_decision_level[var_of(c[i])] > var_to_decision_level[var_of(c[highest])])
+            highest = i;
+    }
+    if (highest == 1)
+        return false;
 
-bool solver::set_signed_value(int signed_var, int reason_clause) {
-    return set_value(abs(signed_var), signed_var > 0, reason_clause);
+    std::swap(c[1], c[highest]);
+    watches[c[1]].push_back({cref, c[0]});
+    return true;
 }
 
-value_state solver::get_signed_value(int signed_var) {
-    auto var = abs(signed_var);
-    auto value = values[var];
-    if (value == UNDEF)
-        return UNDEF;
+template <typename Config>
+void solver<Config>::unset_value(int var) {
+    if constexpr (Config::checks) {
+        if (values[make_literal(var, false)] == UNDEF)
+            debug_logic_error("Trying to unset already undefined var: " << var)
+    }
 
-    if ((value == TRUE) ^ (signed_var < 0))
-        return TRUE;
-    else
-        return FALSE;
+    saved_phases[var] = values[make_literal(var, false)];
+    values[make_literal(var, false)] = UNDEF;
+    values[make_literal(var, true)] = UNDEF;
+    antecedents[var] = reason();
+    values_count--;
+    unassigned_vars.insert(var);
+    heuristic.on_var_unset(var);
 }
 
-bool solver::add_clause(const std::vector<int>& clause, int next_decision_level) {
-    debug(
-        auto duplicate = clause_filter.find(clause) != clause_filter.end();
-        if (duplicate) {
-            debug_logic_error("Tried to add already existed clause")
+template <typename Config>
+void solver<Config>::set_prior_value(literal lit) {
+    if (prior_values[var_of(lit)] == UNDEF)
+        priors++;
+    // binary clauses of the variable are satisfied or become units, so its neighbors are probed again
+    for (auto side: {lit, negate(lit)}) {
+        for (auto other: implications[side]) {
+            probe_dirty[var_of(other)] = true;
         }
-        clause_filter.insert(clause);
-    )
-    trace("New clause: " << trace_print_vector(clause))
-
-    static std::unordered_set<int> levels;
-    levels.clear();
-    for (auto signed_var: clause) {
-        auto level = var_to_decision_level[abs(signed_var)];
-        if (level == 0)
-            continue;
-
-        levels.insert(level);
     }
 
-    clauses.push_back(clause);
-    learnt_clause_stat.emplace_back(levels.size(), 0);
-    auto clause_id = (int) (clauses.size() - 1);
+    prior_values[var_of(lit)] = is_negative(lit) ? FALSE : TRUE;
+}
 
-    debug(if (clause.size() <= 1)
-        debug_logic_error("Size of new clause is too small: " << clause.size()))
+template <typename Config>
+value_state solver<Config>::get_value(literal lit) {
+    return values[lit];
+}
 
-    auto watch1 = 0, watch2 = 0;
-    for (auto signed_var: clause) {
-        if (get_signed_value(signed_var) == UNDEF ||
-            var_to_decision_level[abs(signed_var)] >= next_decision_level ||
-            (var_to_decision_level[abs(signed_var)] == 0 && next_decision_level == 1)) {
-            if (watch1 == 0) {
-                watch1 = signed_var;
-            } else {
-                watch2 = signed_var;
-                break;
-            }
+template <typename Config>
+reason solver<Config>::add_clause(const std::vector<literal>& clause, uint32_t lbd) {
+    if constexpr (Config::checks) {
+        auto key = filter_key(clause.data(), clause.data() + clause.size());
+        // with out-of-order levels a clause may be learnt again while it is falsified and not visited yet
+        auto duplicate = clause_filter.find(key) != clause_filter.end();
+        if (duplicate && !Config::chrono_backtrack) {
+            debug_logic_error("Tried to add already existed clause")
         }
+        clause_filter.insert(key);
     }
-    debug(if (watch1 == 0 || watch2 == 0)
-        debug_logic_error("Could not find potentially UNDEF watch variables for new clause, watch1 = " << watch1 << ", watch2 = " << watch2))
+    trace("New clause: " << trace_print_vector(to_signed(clause)))
 
-    watch_vars.emplace_back(watch1, watch2);
-    if (watch1 > 0) {
-        pos_var_to_watch_clauses[watch1].push_back(clause_id);
-    } else {
-        neg_var_to_watch_clauses[-watch1].push_back(clause_id);
+    if constexpr (Config::checks) {
+        if (clause.size() <= 1)
+            debug_logic_error("Size of new clause is too small: " << clause.size())
     }
-    if (watch2 > 0) {
-        pos_var_to_watch_clauses[watch2].push_back(clause_id);
-    } else {
-        neg_var_to_watch_clauses[-watch2].push_back(clause_id);
+
+    if (clause.size() == 2) {
+        add_binary_clause(clause[0], clause[1]);
+        learnt_binary_count++;
+        return reason::binary(clause[1]);
     }
-    return true;
+
+    auto cref = clauses.alloc(clause, true);
+    auto& c = clauses[cref];
+    c.lbd = lbd;
+    c.tier = c.lbd <= core_lbd_limit ? CORE : c.lbd <= tier2_lbd_limit ? TIER2 : LOCAL;
+    learnt_clauses.push_back(cref);
+    bump_clause(c);
+
+    // watched literals are already in the first two positions
+    watch_clause(cref);
+    return reason::long_clause(cref);
+}
+
+// Literals of a clause are reordered by watches, so the filter stores them sorted
+template <typename Config>
+std::vector<literal> solver<Config>::filter_key(const literal* begin, const literal* end) {
+    std::vector<literal> key(begin, end);
+    std::sort(key.begin(), key.end());
+    return key;
 }
 
-void solver::print_format_seconds(double duration) {
+template <typename Config>
+void solver<Config>::print_format_seconds(double duration) {
     auto units = "seconds";
     if (duration > 3600) {
         duration /= 3600;
@@ -655,59 +1530,73 @@ void solver::print_format_seconds(double duration) {
     std::cout << duration << " " << units << std::endl;
 }
 
-void solver::slow_log() {
+template <typename Config>
+void solver<Config>::slow_log() {
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
     std::cout << "Elapsed time: ";
     print_format_seconds(elapsed.count() / 1000.0);
     print_statistics(elapsed);
 }
 
-bool solver::timer_log() {
-    constexpr int iterations = 20000;
-    constexpr int64_t interval = 5000;
-
-    log_iteration++;
-    if (log_iteration == iterations) {
-        log_iteration = 0;
+// Stops the search once the tick limit is reached. The clock is only polled every clock_poll_ticks ticks,
+// for progress logs and the wall-clock timeout, which is a safety limit and not a part of the search.
+template <typename Config>
+bool solver<Config>::timer_log() {
+    if (options.tick_limit > 0 && ticks >= options.tick_limit)
+        return false;
 
-        auto now = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - log_time);
-        if (duration.count() >= interval) {
-            log_time = now;
-            slow_log();
+    if (ticks < next_clock_poll)
+        return true;
 
-            auto duration_from_start = std::chrono::duration_cast<std::chrono::seconds>(now - start_time);
-            if (duration_from_start > timeout)
-                return false;
-        }
+    next_clock_poll = ticks + clock_poll_ticks;
+    auto now = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - log_time);
+    if (duration.count() >= log_interval_ms) {
+        log_time = now;
+        slow_log();
     }
-    return true;
+
+    auto duration_from_start = std::chrono::duration_cast<std::chrono::seconds>(now - start_time);
+    return duration_from_start <= timeout;
 }
 
-bool solver::verify_result() {
+template <typename Config>
+bool solver<Config>::verify_result() {
     auto result = true;
-    for (auto clause_id = 0; clause_id < initial_clauses_count; clause_id++) {
-        const auto& clause = clauses[clause_id];
+    for (auto cref: original_clauses) {
+        const auto& c = clauses[cref];
         auto all_false = true;
-        for (auto signed_var: clause) {
-            if (get_signed_value(signed_var) != FALSE) {
+        for (auto lit: c) {
+            if (get_value(lit) != FALSE) {
                 all_false = false;
                 break;
             }
         }
         if (all_false) {
-            info(trace_print_vector(clause) << " => false")
+            info(trace_print_vector(to_signed(std::vector<literal>(c.begin(), c.end()))) << " => false")
             result = false;
         }
     }
+    for (literal lit = 2; lit < implications.size(); lit++) {
+        if (get_value(lit) != FALSE)
+            continue;
+
+        for (auto implied: implications[lit]) {
+            if (get_value(implied) == FALSE) {
+                info(to_signed(lit) << " " << to_signed(implied) << " => false")
+                result = false;
+            }
+        }
+    }
     return result;
 }
 
-std::pair<sat_result, std::vector<int8_t>> solver::report_result(bool result) {
+template <typename Config>
+std::pair<sat_result, std::vector<int8_t>> solver<Config>::report_result(bool result) {
     if (result) {
         std::cout << "SAT" << std::endl;
-        debug(if (!verify_result())
-            debug_logic_error("Found solution is not a solution"))
+        if (Config::checks && !verify_result())
+            debug_logic_error("Found solution is not a solution")
     } else {
         std::cout << "UNSAT" << std::endl;
     }
@@ -720,7 +1609,7 @@ std::pair<sat_result, std::vector<int8_t>> solver::report_result(bool result) {
         std::vector<int8_t> result_values;
         result_values.push_back(0);
         for (auto var = 1; var <= nb_vars; var++) {
-            result_values.push_back(values[var]);
+            result_values.push_back(values[make_literal(var, false)]);
         }
         return std::make_pair(SAT, result_values);
     } else {
@@ -728,17 +1617,61 @@ std::pair<sat_result, std::vector<int8_t>> solver::report_result(bool result) {
     }
 }
 
-void solver::print_statistics(std::chrono::milliseconds elapsed) {
+template <typename Config>
+void solver<Config>::print_statistics(std::chrono::milliseconds elapsed) {
     auto propagates_per_second = (double) propagations / elapsed.count() * 1000;
     auto conflicts_per_second = (double) conflicts / elapsed.count() * 1000;
 
     std::cout << "Decisions made: \t" << decisions << std::endl;
     std::cout << "Variables propagated: \t" << propagations << ", \t" << propagates_per_second << " / sec" << std::endl;
+    std::cout << "Ticks: \t\t\t" << ticks << ", \t" << (double) ticks / elapsed.count() * 1000 << " / sec" << std::endl;
     std::cout << "Conflicts resolved: \t" << conflicts << ", \t" << conflicts_per_second << " / sec" << std::endl;
+    auto average_learnt_size = learnt_count > 0 ? (double) learnt_literals / learnt_count : 0.0;
+    std::cout << "Learnt literals: \t" << learnt_literals << ", \t" << average_learnt_size << " / clause"
+              << " (removed by minimization: " << minimized_literals << ")" << std::endl;
     std::cout << "Deduced values: \t" << priors
               << " (of total " << nb_vars << ")" << std::endl;
-    std::cout << "Clause count: \t\t" << clauses.size()
-              << " (learned clauses: " << (clauses.size() - initial_clauses_count)
-              << " with limit " << current_clause_limit << ")" << std::endl;
+    size_t binary_count = 0;
+    for (const auto& implied: implications) {
+        binary_count += implied.size();
+    }
+    binary_count /= 2;
+    std::cout << "Clause count: \t\t" << original_clauses.size() + learnt_clauses.size() + binary_count
+              << " (learned clauses: " << learnt_clauses.size()
+              << ")" << std::endl;
+    auto average_reused_levels = restart_count > 0 ? (double) reused_levels / restart_count : 0.0;
+    std::cout << "Restarts: \t\t" << restart_count << " (reused levels: " << average_reused_levels << " / restart"
+              << ", rephases: " << rephase_count << ")" << std::endl;
+    std::cout << "Probing: \t\t" << probe_rounds << " rounds (failed: " << failed_literals
+              << ", hyper-binary: " << hyper_binaries << ", equivalences: " << equivalences << ")" << std::endl;
+    if (options.local_search) {
+        auto average_best_unsat = walk_count > 0 ? (double) walker.best_unsat_total / walk_count : 0.0;
+        std::cout << "Local search: \t\t" << walk_count << " walks (flips: " << walker.flips
+                  << ", ticks: " << walker.ticks
+                  << ", best unsatisfied: " << average_best_unsat << " / walk)" << std::endl;
+    }
+    if constexpr (Config::chrono_backtrack) {
+        std::cout << "Chrono backtracks: \t" << chrono_backtracks
+                  << " (conflicts below current level: " << lower_conflicts << ")" << std::endl;
+    }
+    size_t tier_count[3] = {0, 0, 0};
+    for (auto cref: learnt_clauses) {
+        tier_count[clauses[cref].tier]++;
+    }
+    std::cout << "Learnt tiers: \t\t" << "core " << tier_count[CORE] << ", tier2 " << tier_count[TIER2]
+              << ", local " << tier_count[LOCAL] << " (reductions: " << reductions
+              << ", removed: " << reduced_clauses << ", subsumed: " << subsumed_clauses
+              << ", collections: " << garbage_collections << ")" << std::endl;
+    std::cout << "Binary clauses: \t" << binary_count
+              << " (learned: " << learnt_binary_count << ")" << std::endl;
+    std::cout << "Clause arena: \t\t" << clauses.size_words() * sizeof(uint32_t) / 1024 << " KiB"
+              << " (wasted: " << clauses.wasted_words() * sizeof(uint32_t) / 1024 << " KiB)" << std::endl;
+    std::cout << "Watch search: \t\t" << watch_search::selected_name(options.watch_search) << std::endl;
+    std::cout << "Propagation: \t\t" << (prefetch_watches ? "prefetch" : "direct") << std::endl;
     std::cout << std::endl;
-}
\ No newline at end of file
+}
+
+template class solver<solver_config<false, false>>;
+template class solver<solver_config<false, true>>;
+template class solver<solver_config<true, false>>;
+template class solver<solver_config<true, true>>;
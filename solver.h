@@ -4,18 +4,60 @@
 #include "dimacs.h"
 #include "debug.h"
 #include "solver_types.h"
-#include "vsids_picker.h"
+#include "decision_heuristic.h"
+#include "clause_arena.h"
+#include "solver_options.h"
+#include "restart_scheduler.h"
+#include "fast_random.h"
+#include "unassigned_set.h"
+#include "watch_search.h"
+#include "local_search.h"
+#include "parallel_probing.h"
+#include "subsumption.h"
+#include "solver_config.h"
 #include <vector>
 #include <chrono>
-#include <queue>
-
-#ifdef DEBUG
 #include <unordered_set>
-#endif
 
 struct snapshot {
     int next_var;
-    size_t values_stack_length;
+    size_t trail_length;
+};
+
+// Clause in a watch list together with a literal of it: if the blocker is true, the clause is satisfied
+struct watcher {
+    clause_ref cref;
+    literal blocker;
+};
+
+// Reason of an implied value: either a clause from the arena or the other literal of a binary clause
+class reason {
+    uint32_t tagged;
+
+    static constexpr uint32_t binary_tag = 1u << 31;
+
+    explicit reason(uint32_t tagged) : tagged(tagged) {}
+
+public:
+    reason() : tagged(clause_ref_undef) {}
+
+    static reason long_clause(clause_ref cref) {
+        return reason(cref);
+    }
+
+    static reason binary(literal lit) {
+        return reason(binary_tag | lit);
+    }
+
+    bool is_undef() const { return tagged == clause_ref_undef; }
+    bool is_binary() const { return !is_undef() && (tagged & binary_tag) != 0; }
+    bool is_clause() const { return (tagged & binary_tag) == 0; }
+
+    clause_ref get_clause() const { return tagged; }
+
+    literal get_binary_literal() const {
+        return tagged & ~binary_tag;
+    }
 };
 
 enum sat_result {
@@ -24,11 +66,6 @@ enum sat_result {
     UNKNOWN = 2
 };
 
-enum class polarity_mode {
-    TRUE, FALSE, RANDOM
-};
-
-debug_def(
 template <class T>
 inline void hash_combine(std::size_t& seed, T const& v)
 {
@@ -52,101 +89,224 @@ namespace std
         }
     };
 }
-)
-
-struct clause_stat {
-    uint32_t lbd;
-    uint32_t used;
-
-    clause_stat() = delete;
-    clause_stat(uint32_t lbd, uint32_t used) : lbd(lbd), used(used) {}
-};
 
+// CDCL solver, Config is a solver_config
+template <typename Config>
 class solver {
     unsigned int nb_vars;
-    std::vector<std::vector<int>> clauses;
+    solver_options options;
+    clause_arena clauses;
+    std::vector<clause_ref> original_clauses;
+    std::vector<clause_ref> learnt_clauses;
+    clause_ref learnt_clauses_start;
 
-    // static state
-    std::vector<std::vector<int>> pos_var_to_watch_clauses;
-    std::vector<std::vector<int>> neg_var_to_watch_clauses;
-    std::vector<std::pair<int, int>> watch_vars;
+    // static state, watches and implications are indexed by the literal that becomes false
+    std::vector<std::vector<watcher>> watches;
+    std::vector<std::vector<literal>> implications;
     std::vector<value_state> prior_values;
-    vsids_picker<solver> vsids;
-    std::vector<clause_stat> learnt_clause_stat;
-    debug_def(std::unordered_set<std::vector<int>> clause_filter;)
-    size_t initial_clauses_count;
-    size_t current_clause_limit;
+    decision_heuristic<solver> heuristic;
+    restart_scheduler restarts;
+    fast_random random;
+    watch_search_fn find_non_false;
+    bool prefetch_watches;
+    local_search<solver> walker;
+    parallel_probing<solver> parallel_prober;
+    subsumption subsumer;
+    // learnt clauses that are checked for duplicates, only with Config::checks
+    std::unordered_set<std::vector<literal>> clause_filter;
+    int64_t next_reduce;
+    int64_t reduce_interval;
+    double clause_activity_inc;
+    int64_t next_rephase;
+    int64_t rephase_interval;
+    int64_t next_probe;
+    int64_t probe_interval;
+    int64_t probe_ticks;
+    int64_t next_walk;
+    int64_t walk_interval;
+    int64_t walk_ticks;
+    int64_t subsume_ticks;
     std::chrono::seconds timeout;
 
     // volatile state
     bool unsat;
-    int conflict_clause;
-    std::queue<int> propagation_queue;
+    reason conflict_reason;
+    literal conflict_literal;
+    std::vector<literal> learnt_clause;
+    std::vector<uint32_t> seen_stamps;
+    uint32_t seen_epoch;
+    std::vector<literal> minimize_stack;
+    std::vector<uint32_t> minimize_to_clear;
+    std::vector<uint32_t> level_stamps;
+    uint32_t level_epoch;
+    std::vector<clause_ref> reduce_candidates;
+    // copies of learnt clauses for subsumption and their references
+    std::vector<std::vector<literal>> subsume_clauses;
+    std::vector<clause_ref> subsume_refs;
+    // literals of live learnt clauses by clause size
+    std::vector<int64_t> subsume_size_literals;
+    std::vector<std::pair<clause_ref, clause_ref>> relocations;
+    std::vector<bool> probe_dirty;
+    // roots of the binary implication graph in the current probing round
+    std::vector<literal> probes;
+    std::vector<uint32_t> probe_stamps;
+    uint32_t probe_epoch;
+    std::vector<value_state> probe_values;
+    std::vector<literal> probe_parents;
+    std::vector<int> probe_depths;
+    std::vector<literal> probe_units;
+    std::vector<literal> probe_equivalent;
+    std::vector<literal> probe_batch;
 
-    // backtrackable state
+    // backtrackable state, values are indexed by literal
     std::vector<value_state> values;
     size_t values_count;
-    std::vector<int> antecedent_clauses;
-    std::vector<int> var_implied_depth;
+    unassigned_set unassigned_vars;
+    std::vector<reason> antecedents;
     std::vector<int> var_to_decision_level;
 
-    // stack of state changes
-    std::vector<int> values_stack;
+    // phases are indexed by variable, UNDEF if a phase was never recorded
+    std::vector<value_state> saved_phases;
+    std::vector<value_state> target_phases;
+    std::vector<value_state> best_phases;
+    size_t target_assigned;
+    size_t best_assigned;
+
+    // assigned literals in order of assignment, the unpropagated tail serves as a propagation queue
+    std::vector<literal> trail;
+    size_t binary_propagation_head;
+    size_t propagation_head;
     std::vector<snapshot> snapshots;
 
     // internal stuff
-    int log_iteration;
+    int64_t next_clock_poll;
     std::chrono::steady_clock::time_point log_time;
     std::chrono::steady_clock::time_point start_time;
 
     // statistics
     int64_t decisions;
     int64_t propagations;
+    // deterministic measure of work: watch lists and clauses visited, cache lines of long clauses scanned
+    int64_t ticks;
     int64_t conflicts;
     int64_t priors;
+    int64_t learnt_binary_count;
+    int64_t learnt_count;
+    int64_t learnt_literals;
+    int64_t minimized_literals;
+    int64_t reductions;
+    int64_t reduced_clauses;
+    int64_t subsumed_clauses;
+    int64_t garbage_collections;
+    int64_t restart_count;
+    int64_t reused_levels;
+    int64_t rephase_count;
+    int64_t chrono_backtracks;
+    int64_t lower_conflicts;
+    int64_t walk_count;
+    int64_t probe_rounds;
+    int64_t failed_literals;
+    int64_t hyper_binaries;
+    int64_t equivalences;
 
     // constants
     static constexpr double random_pick_var_prob = 0.01;
-    static constexpr double clause_limit_init_factor = 1.0 / 3.0;
-    static constexpr double clause_limit_inc_factor = 1.1;
-    static constexpr double clause_keep_ratio = 0.5;
-    static constexpr polarity_mode pick_polarity_mode = polarity_mode::FALSE;
-    static constexpr std::chrono::seconds probe_timeout {20};
+    static constexpr uint32_t long_clause_size = 16;
+    static constexpr uint32_t core_lbd_limit = 2;
+    static constexpr uint32_t tier2_lbd_limit = 6;
+    static constexpr int64_t reduce_interval_init = 2000;
+    static constexpr int64_t reduce_interval_inc = 300;
+    static constexpr double local_reduce_ratio = 0.5;
+    static constexpr double clause_activity_decay = 0.999;
+    static constexpr double garbage_ratio = 0.25;
+    static constexpr double subsume_effort = 0.02;
+    static constexpr int64_t min_subsume_ticks = 10000;
+    static constexpr int64_t rephase_interval_init = 1000;
+    static constexpr int64_t rephase_interval_inc = 1000;
+    static constexpr int64_t walk_interval_init = 2000;
+    static constexpr int64_t walk_interval_inc = 2000;
+    static constexpr int64_t min_walk_ticks = 150000;
+    static constexpr int64_t initial_probe_ticks = 10000000;
+    static constexpr int64_t min_probe_ticks = 100000;
+    static constexpr double probe_effort = 0.1;
+    static constexpr int64_t probe_interval_init = 5000;
+    static constexpr int64_t probe_interval_inc = 5000;
+    static constexpr uint32_t literals_per_tick = 16;
+    static constexpr uint32_t prefetch_batch = 8;
+    static constexpr size_t default_cache_size = 32 << 20;
+    static constexpr int64_t clock_poll_ticks = 1 << 20;
+    static constexpr int64_t log_interval_ms = 5000;
 public:
     explicit solver(
             const dimacs& formula,
-            std::chrono::seconds timeout
+            std::chrono::seconds timeout,
+            const solver_options& options = solver_options()
     );
     std::pair<sat_result, std::vector<int8_t>> solve();
 
 private:
-    void init(bool restart);
+    void init();
+    void restart();
 
     int pick_var();
     int pick_var_random();
 
-    bool pick_polarity();
+    bool pick_polarity(int var);
+    bool initial_polarity();
+    void update_phases(size_t trail_length);
+    void rephase();
+    bool walk();
     void take_snapshot(int next_var);
     void backtrack();
     void backtrack_until(int decision_level);
     int current_decision_level();
-    std::vector<int> find_1uip_conflict_clause();
-    int analyse_conflict(int& deduced_signed_var);
-    void probe_literals();
+    void next_seen_epoch();
+    std::vector<literal>& find_1uip_conflict_clause();
+    void minimize_learnt_clause();
+    bool is_redundant(literal lit, uint32_t abstract_levels);
+    uint32_t abstract_level(uint32_t var);
+    int conflict_level();
+    bool analyse_lower_conflict(int level);
+    int analyse_conflict(int level);
+    void bump_clause(clause& c);
+    uint32_t compute_lbd(const literal* begin, const literal* end);
+
+    void reduce_learnt_clauses();
+    void subsume_learnt_clauses();
+    bool is_locked(clause_ref cref);
+    void remove_clause(clause_ref cref);
+    void collect_garbage();
+    void collect_probes(std::vector<literal>& probes);
+    void probe_literals(int64_t budget);
+    void probe_pair(literal lit);
+    void probe_parallel(const std::vector<literal>& probes, size_t& next);
+    void add_equivalence(literal lit, literal implied);
+    bool probe(literal lit);
+    literal probe_dominator(literal a, literal b);
+    void probe_in_search();
 
     void propagate_all(bool prior = false);
-    void propagate_var(int var, bool prior);
+    void propagate_binary(literal lit, bool prior);
+    void select_propagation();
+    void propagate_literal(literal lit, bool prior);
+    template <bool prefetch>
+    void propagate_watches(literal lit, bool prior);
+    void prefetch_blockers(const watcher* begin, const watcher* end);
+    void prefetch_clauses(const watcher* begin, const watcher* end);
 
-    bool set_value(int var, bool value, int reason_clause);
+    bool set_value(literal lit, reason reason);
+    int reason_level(reason reason);
+    bool watch_highest_level(clause_ref cref);
     void unset_value(int var);
 
-    bool add_clause(const std::vector<int>& clause, int next_decision_level);
+    reason add_clause(const std::vector<literal>& clause, uint32_t lbd);
+    static std::vector<literal> filter_key(const literal* begin, const literal* end);
 
     void apply_prior_values();
-    bool set_signed_value(int signed_var, int reason_clause);
-    value_state get_signed_value(int signed_var);
-    void replace_watch_var(std::vector<int>& from_watch_clauses, int clause_id, int signed_other_var, int signed_to_var);
-    void set_prior_value(int signed_var);
+    value_state get_value(literal lit);
+    void watch_clause(clause_ref cref);
+    void add_binary_clause(literal first, literal second);
+    void set_prior_value(literal lit);
 
     bool timer_log();
     void slow_log();
@@ -158,6 +318,10 @@ private:
     void print_format_seconds(double duration);
 
     friend class vsids_picker<solver>;
+    friend class vmtf_picker<solver>;
+    friend class lrb_picker<solver>;
+    friend class local_search<solver>;
+    friend class parallel_probing<solver>;
 };
 
 #endif //SATSOLVER_SOLVER_H
@@ -0,0 +1,14 @@
+#ifndef SATSOLVER_SOLVER_CONFIG_H
+#define SATSOLVER_SOLVER_CONFIG_H
+
+// Features of the solver fixed at compile time, the hot path carries no branches for disabled ones.
+// solver_runner instantiates every combination and picks one by the solver options.
+template <bool ChronoBacktrack, bool Checks>
+struct solver_config {
+    // backtrack one level instead of long backjumps, conflict analysis and propagation then track levels of literals
+    static constexpr bool chrono_backtrack = ChronoBacktrack;
+    // consistency checks of the solver state, learnt clauses and found solutions
+    static constexpr bool checks = Checks;
+};
+
+#endif //SATSOLVER_SOLVER_CONFIG_H
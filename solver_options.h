@@ -0,0 +1,121 @@
+#ifndef SATSOLVER_SOLVER_OPTIONS_H
+#define SATSOLVER_SOLVER_OPTIONS_H
+
+#include <cstdint>
+#include <string>
+
+enum class restart_policy {
+    NONE, LUBY, GLUCOSE
+};
+
+enum class polarity_mode {
+    TRUE, FALSE, RANDOM
+};
+
+enum class heuristic_kind {
+    VSIDS, VMTF, LRB
+};
+
+// kernel used to find a replacement watch in long clauses
+enum class watch_search_mode {
+    AUTO, SCALAR, AVX2
+};
+
+// processing of watch lists: one watcher at a time, or in batches with prefetching of clauses and values
+enum class propagation_mode {
+    AUTO, DIRECT, PREFETCH
+};
+
+// chrono_backtrack and checks select a compile-time configuration of the solver, see solver_config.h
+struct solver_options {
+    heuristic_kind heuristic = heuristic_kind::VSIDS;
+    restart_policy restart = restart_policy::GLUCOSE;
+    // number of conflicts in one unit of the Luby sequence
+    int64_t luby_unit = 100;
+    // initial value of decision variables, and the only one if phase saving is off
+    polarity_mode polarity = polarity_mode::FALSE;
+    bool phase_saving = true;
+    // prefer values from the longest conflict-free trail since the last restart to saved ones
+    bool target_phases = true;
+    uint64_t seed = 0;
+    // walk with ProbSAT from time to time, the best assignment becomes the saved phases
+    bool local_search = true;
+    // ticks of a walk per tick of search made since the previous walk
+    double local_search_effort = 0.1;
+    // probe 32 literals in both polarities at once, without hyper-binary resolution
+    bool parallel_probing = true;
+    watch_search_mode watch_search = watch_search_mode::AUTO;
+    propagation_mode propagation = propagation_mode::AUTO;
+    // backtrack one level instead of backjumping further than chrono_distance levels
+    bool chrono_backtrack = false;
+    int chrono_distance = 100;
+    // consistency checks of the solver, slow
+    bool checks = false;
+    // the search gives up after this many ticks, 0 means no limit
+    int64_t tick_limit = 0;
+    // number of clauses the preprocessor may add by eliminating a variable
+    int32_t elimination_growth = 0;
+    // blocked clause elimination in the preprocessor
+    bool blocked_clause_elimination = false;
+    // threads of the preprocessor, its result depends on their number but not on their timing
+    uint32_t preprocess_threads = 1;
+};
+
+inline const char* heuristic_name(heuristic_kind kind) {
+    switch (kind) {
+        case heuristic_kind::VSIDS:
+            return "vsids";
+        case heuristic_kind::VMTF:
+            return "vmtf";
+        case heuristic_kind::LRB:
+            return "lrb";
+    }
+    return "unknown";
+}
+
+inline bool parse_heuristic(const std::string& name, heuristic_kind& kind) {
+    for (auto candidate: {heuristic_kind::VSIDS, heuristic_kind::VMTF, heuristic_kind::LRB}) {
+        if (name == heuristic_name(candidate)) {
+            kind = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool parse_watch_search(const std::string& name, watch_search_mode& mode) {
+    if (name == "auto") {
+        mode = watch_search_mode::AUTO;
+    } else if (name == "scalar") {
+        mode = watch_search_mode::SCALAR;
+    } else if (name == "avx2") {
+        mode = watch_search_mode::AVX2;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline const char* propagation_name(propagation_mode mode) {
+    switch (mode) {
+        case propagation_mode::AUTO:
+            return "auto";
+        case propagation_mode::DIRECT:
+            return "direct";
+        case propagation_mode::PREFETCH:
+            return "prefetch";
+    }
+    return "unknown";
+}
+
+inline bool parse_propagation(const std::string& name, propagation_mode& mode) {
+    for (auto candidate: {propagation_mode::AUTO, propagation_mode::DIRECT, propagation_mode::PREFETCH}) {
+        if (name == propagation_name(candidate)) {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif //SATSOLVER_SOLVER_OPTIONS_H
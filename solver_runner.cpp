@@ -2,9 +2,11 @@
 #include <chrono>
 #include "solver_runner.h"
 
-solver_runner::solver_runner(const std::string &filename)
+solver_runner::solver_runner(const std::string &filename, const solver_options& options)
         : original_formula(dimacs::read(filename)),
-          preprocesor(original_formula),
+          options(options),
+          preprocesor(original_formula, options.elimination_growth, options.blocked_clause_elimination,
+                      options.preprocess_threads),
           solved(false) {}
 
 sat_result solver_runner::solve(bool preprocess, std::chrono::seconds timeout) {
@@ -12,8 +14,7 @@ sat_result solver_runner::solve(bool preprocess, std::chrono::seconds timeout) {
         return result;
 
     if (!preprocess) {
-        solver solver(original_formula, timeout);
-        auto [solve_result, values] = solver.solve();
+        auto [solve_result, values] = solve_formula(original_formula, timeout, options);
         if (solve_result == SAT) {
             answer.insert(answer.begin(), values.begin(), values.end());
         }
@@ -23,8 +24,7 @@ sat_result solver_runner::solve(bool preprocess, std::chrono::seconds timeout) {
         if (formula.clauses.size() == 1 && formula.clauses[0].empty()) {
             result = UNSAT;
         } else {
-            solver solver(formula, timeout);
-            auto[solve_result, values] = solver.solve();
+            auto [solve_result, values] = solve_formula(formula, timeout, options);
             if (solve_result == SAT) {
                 auto remapped_values = remapper.remap(values);
                 answer.insert(answer.begin(), remapped_values.begin(), remapped_values.end());
@@ -40,6 +40,25 @@ sat_result solver_runner::solve(bool preprocess, std::chrono::seconds timeout) {
     return result;
 }
 
+template <typename Config>
+static std::pair<sat_result, std::vector<int8_t>> solve_with_config(const dimacs& formula, std::chrono::seconds timeout,
+                                                                    const solver_options& options) {
+    solver<Config> solver(formula, timeout, options);
+    return solver.solve();
+}
+
+// Instantiated solver configurations, indexed by chrono_backtrack and checks
+static constexpr std::pair<sat_result, std::vector<int8_t>> (*solvers[2][2])(
+        const dimacs&, std::chrono::seconds, const solver_options&) = {
+        {solve_with_config<solver_config<false, false>>, solve_with_config<solver_config<false, true>>},
+        {solve_with_config<solver_config<true, false>>, solve_with_config<solver_config<true, true>>}
+};
+
+std::pair<sat_result, std::vector<int8_t>> solver_runner::solve_formula(const dimacs& formula, std::chrono::seconds timeout,
+                                                                        const solver_options& options) {
+    return solvers[options.chrono_backtrack][options.checks](formula, timeout, options);
+}
+
 sat_result solver_runner::get_result() {
     if (!solved)
         throw std::logic_error("Can't get result: instance was not solved");
@@ -6,21 +6,25 @@
 #include "sat_preprocessor.h"
 #include "sat_remapper.h"
 #include "solver.h"
+#include "solver_options.h"
 
 class solver_runner {
     dimacs original_formula;
+    solver_options options;
     sat_preprocessor preprocesor;
     sat_result result;
     std::vector<int8_t> answer;
     bool solved;
 public:
-    explicit solver_runner(const std::string& filename);
+    explicit solver_runner(const std::string& filename, const solver_options& options = solver_options());
     sat_result solve(bool preprocess = true, std::chrono::seconds timeout = std::chrono::seconds::max());
     sat_result get_result();
     const std::vector<int8_t>& get_answer();
     const dimacs& get_formula();
 
 private:
+    static std::pair<sat_result, std::vector<int8_t>> solve_formula(const dimacs& formula, std::chrono::seconds timeout,
+                                                                    const solver_options& options);
     static bool verify_result(const dimacs& formula, const std::vector<int8_t>& values);
 };
 
@@ -1,10 +1,61 @@
 #ifndef SATSOLVER_SOLVER_TYPES_H
 #define SATSOLVER_SOLVER_TYPES_H
 
-enum value_state {
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+enum value_state : int8_t {
     FALSE = false,
     TRUE = true,
     UNDEF = 2
 };
 
+// Literal in the internal encoding: 2 * var + sign, where sign is 1 for a negated variable.
+// Signed DIMACS literals are converted only when a formula enters or leaves the solver.
+typedef uint32_t literal;
+
+inline literal make_literal(uint32_t var, bool negative) {
+    return (var << 1) | (uint32_t) negative;
+}
+
+inline uint32_t var_of(literal lit) {
+    return lit >> 1;
+}
+
+inline bool is_negative(literal lit) {
+    return (lit & 1) != 0;
+}
+
+inline literal negate(literal lit) {
+    return lit ^ 1;
+}
+
+inline literal to_literal(int signed_var) {
+    return make_literal((uint32_t) abs(signed_var), signed_var < 0);
+}
+
+inline int to_signed(literal lit) {
+    auto var = (int) var_of(lit);
+    return is_negative(lit) ? -var : var;
+}
+
+inline std::vector<literal> to_literals(const std::vector<int>& signed_clause) {
+    std::vector<literal> result;
+    result.reserve(signed_clause.size());
+    for (auto signed_var: signed_clause) {
+        result.push_back(to_literal(signed_var));
+    }
+    return result;
+}
+
+inline std::vector<int> to_signed(const std::vector<literal>& clause) {
+    std::vector<int> result;
+    result.reserve(clause.size());
+    for (auto lit: clause) {
+        result.push_back(to_signed(lit));
+    }
+    return result;
+}
+
 #endif //SATSOLVER_SOLVER_TYPES_H
@@ -0,0 +1,340 @@
+#ifndef SATSOLVER_SUBSUMPTION_H
+#define SATSOLVER_SUBSUMPTION_H
+
+#include "debug.h"
+#include "solver_types.h"
+#include "sat_utils.h"
+#include "thread_pool.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// Subsumption and self-subsuming resolution [11] over clauses stored as literal vectors. Clauses are checked
+// from the shortest one against the shorter clauses kept so far, which are indexed by their least frequent
+// literal only, 64-bit signatures of variables reject most candidates without a scan. A strengthened clause
+// may subsume or strengthen clauses checked before it, so it's checked backward against all clauses later.
+// The parallel run checks every clause against all others at once and applies the results afterwards.
+class subsumption {
+    // kept clauses by their least frequent literal
+    std::vector<std::vector<uint32_t>> watches;
+    // all clauses containing a literal, for the backward checks
+    std::vector<std::vector<uint32_t>> occurrences;
+    std::vector<uint32_t> literal_count;
+    // literals counted in the last run, only their counts and lists are reset for the next one
+    std::vector<literal> counted_literals;
+    std::vector<uint64_t> signatures;
+    std::vector<bool> marked;
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> strengthened_clauses;
+    // parallel run: position of a clause in the order, and the subsumer and flipped literal found for it
+    std::vector<uint32_t> rank;
+    std::vector<std::pair<uint32_t, literal>> results;
+    std::vector<std::vector<bool>> task_marked;
+    std::vector<int64_t> task_ticks;
+
+    // result of a subset check: the clause isn't contained in the marked one
+    static constexpr literal not_subset = UINT32_MAX;
+
+public:
+    int64_t ticks;
+    int64_t subsumed;
+    int64_t strengthened;
+
+    subsumption() : ticks(0), subsumed(0), strengthened(0) {}
+
+    // Invalidates subsumed clauses, `on_subsumed(subsumed, subsumer)` is called with their indices. With
+    // `strengthen`, literals are removed from clauses by self-subsuming resolution, a clause may become empty.
+    template <typename Callback>
+    void run(std::vector<std::vector<literal>>& clauses, uint32_t nb_vars, bool strengthen, int64_t tick_budget,
+             Callback on_subsumed) {
+        prepare(clauses, nb_vars, strengthen);
+        strengthened_clauses.clear();
+
+        // the budget is spent on checks only, setting up is linear
+        auto start_ticks = ticks;
+        for (auto id: order) {
+            if (ticks - start_ticks >= tick_budget)
+                break;
+
+            if (check_forward(clauses, id, strengthen, on_subsumed) && !clauses[id].empty())
+                watches[least_frequent(clauses[id])].push_back(id);
+        }
+        for (size_t i = 0; i < strengthened_clauses.size() && ticks - start_ticks < tick_budget; i++) {
+            check_backward(clauses, strengthened_clauses[i], on_subsumed);
+        }
+    }
+
+    // Checks the clauses on the threads of the pool, each one against the shorter clauses and the earlier ones
+    // of the same size, and applies the results in the order of the clauses. A clause loses at most one literal
+    // in a run. A chain of subsumed clauses ends with a kept one, which may be strengthened but still subsumes
+    // the others. The result depends only on the number of threads, which divides the budget.
+    template <typename Callback>
+    void run_parallel(std::vector<std::vector<literal>>& clauses, uint32_t nb_vars, bool strengthen,
+                      int64_t tick_budget, thread_pool& pool, Callback on_subsumed) {
+        prepare(clauses, nb_vars, false);
+        strengthened_clauses.clear();
+        rank.resize(clauses.size());
+        for (uint32_t position = 0; position < order.size(); position++) {
+            auto id = order[position];
+            rank[id] = position;
+            if (!clauses[id].empty())
+                watches[least_frequent(clauses[id])].push_back(id);
+        }
+        results.assign(order.size(), {UINT32_MAX, not_subset});
+        auto tasks = pool.size();
+        task_marked.resize(tasks);
+        task_ticks.assign(tasks, 0);
+        for (auto& task_marks: task_marked) {
+            task_marks.assign(2 * (nb_vars + 1), false);
+        }
+
+        // positions are interleaved, long clauses at the end of the order are shared by all tasks
+        pool.run(tasks, [&](uint32_t task) {
+            for (auto position = task; position < order.size() && task_ticks[task] < tick_budget / tasks;
+                 position += tasks) {
+                results[position] = check_parallel(clauses, order[position], strengthen, task_marked[task],
+                                                   task_ticks[task]);
+            }
+        });
+        for (auto task_tick: task_ticks) {
+            ticks += task_tick;
+        }
+
+        for (uint32_t position = 0; position < order.size(); position++) {
+            auto id = order[position];
+            auto [subsumer, flipped] = results[position];
+            if (subsumer != UINT32_MAX) {
+                sat_utils::invalidate_clause(clauses[id]);
+                subsumed++;
+                on_subsumed(id, subsumer);
+            } else if (flipped != not_subset) {
+                remove_literal(clauses[id], id, negate(flipped));
+            }
+        }
+    }
+
+private:
+    // Counts literals and computes signatures of the live clauses, which are ordered by size. The setup is
+    // linear in the clauses, not in the variables, unless the number of variables changed.
+    void prepare(std::vector<std::vector<literal>>& clauses, uint32_t nb_vars, bool with_occurrences) {
+        auto literal_limit = 2 * (nb_vars + 1);
+        if (literal_count.size() != literal_limit) {
+            literal_count.assign(literal_limit, 0);
+            reset_lists(watches, literal_limit);
+            reset_lists(occurrences, 0);
+            marked.assign(literal_limit, false);
+        } else {
+            for (auto lit: counted_literals) {
+                literal_count[lit] = 0;
+                watches[lit].clear();
+                if (lit < occurrences.size())
+                    occurrences[lit].clear();
+            }
+        }
+        if (with_occurrences && occurrences.size() != literal_limit)
+            reset_lists(occurrences, literal_limit);
+        counted_literals.clear();
+        signatures.resize(clauses.size());
+        order.clear();
+        for (uint32_t id = 0; id < clauses.size(); id++) {
+            if (sat_utils::is_invalidated(clauses[id]))
+                continue;
+
+            ticks += clauses[id].size();
+            for (auto lit: clauses[id]) {
+                if (literal_count[lit]++ == 0)
+                    counted_literals.push_back(lit);
+                if (with_occurrences)
+                    occurrences[lit].push_back(id);
+            }
+            signatures[id] = signature(clauses[id]);
+            order.push_back(id);
+        }
+        std::stable_sort(order.begin(), order.end(), [&clauses](uint32_t left, uint32_t right) {
+            return clauses[left].size() < clauses[right].size();
+        });
+    }
+
+    // lists keep their memory between runs
+    static void reset_lists(std::vector<std::vector<uint32_t>>& lists, size_t size) {
+        lists.resize(size);
+        for (auto& list: lists) {
+            list.clear();
+        }
+    }
+
+    static uint64_t signature(const std::vector<literal>& clause) {
+        uint64_t result = 0;
+        for (auto lit: clause) {
+            result |= 1ull << (var_of(lit) & 63);
+        }
+        return result;
+    }
+
+    literal least_frequent(const std::vector<literal>& clause) {
+        return *std::min_element(clause.begin(), clause.end(), [this](literal left, literal right) {
+            return literal_count[left] < literal_count[right];
+        });
+    }
+
+    // literal 0 belongs to the unused variable 0 and means that the clause is contained in the marked one,
+    // otherwise the only literal of the clause whose negation is marked, or not_subset
+    static literal check_subset(const std::vector<literal>& clause, const std::vector<bool>& marked,
+                                int64_t& ticks) {
+        ticks += clause.size();
+        literal flipped = 0;
+        for (auto lit: clause) {
+            if (marked[lit])
+                continue;
+
+            if (flipped != 0 || !marked[negate(lit)])
+                return not_subset;
+
+            flipped = lit;
+        }
+        return flipped;
+    }
+
+    literal check_subset(const std::vector<literal>& clause) {
+        return check_subset(clause, marked, ticks);
+    }
+
+    static void mark(const std::vector<literal>& clause, std::vector<bool>& marked, bool value) {
+        for (auto lit: clause) {
+            marked[lit] = value;
+        }
+    }
+
+    void mark(const std::vector<literal>& clause, bool value) {
+        mark(clause, marked, value);
+    }
+
+    // Finds a subsumer of a clause or, failing that, a clause strengthening it, without changing anything
+    std::pair<uint32_t, literal> check_parallel(const std::vector<std::vector<literal>>& clauses, uint32_t id,
+                                                bool strengthen, std::vector<bool>& task_marks,
+                                                int64_t& task_ticks) const {
+        const auto& clause = clauses[id];
+        mark(clause, task_marks, true);
+        std::pair<uint32_t, literal> result {UINT32_MAX, not_subset};
+        for (auto lit: clause) {
+            for (auto watched: {lit, negate(lit)}) {
+                if (watched != lit && !strengthen)
+                    break;
+
+                for (auto other: watches[watched]) {
+                    task_ticks++;
+                    if (other == id || (signatures[other] & ~signatures[id]) != 0
+                        || clauses[other].size() > clause.size())
+                        continue;
+
+                    auto flipped = check_subset(clauses[other], task_marks, task_ticks);
+                    // of two equal clauses the later one is subsumed
+                    if (flipped == 0 && rank[other] < rank[id]) {
+                        result = {other, not_subset};
+                        break;
+                    }
+                    if (flipped != 0 && flipped != not_subset && strengthen && result.second == not_subset)
+                        result.second = flipped;
+                }
+                if (result.first != UINT32_MAX)
+                    break;
+            }
+            if (result.first != UINT32_MAX)
+                break;
+        }
+        mark(clause, task_marks, false);
+        return result;
+    }
+
+    void remove_literal(std::vector<literal>& clause, uint32_t id, literal lit) {
+        clause.erase(std::find(clause.begin(), clause.end(), lit));
+        signatures[id] = signature(clause);
+        strengthened++;
+        strengthened_clauses.push_back(id);
+    }
+
+    // Checks a clause against the kept ones until it can't be strengthened, returns false if it's subsumed
+    template <typename Callback>
+    bool check_forward(std::vector<std::vector<literal>>& clauses, uint32_t id, bool strengthen,
+                       Callback& on_subsumed) {
+        auto& clause = clauses[id];
+        auto changed = true;
+        while (changed) {
+            changed = false;
+            mark(clause, true);
+            uint32_t subsumer = UINT32_MAX;
+            literal flipped = not_subset;
+            for (auto lit: clause) {
+                for (auto watched: {lit, negate(lit)}) {
+                    if (watched != lit && !strengthen)
+                        break;
+
+                    for (auto other: watches[watched]) {
+                        ticks++;
+                        if ((signatures[other] & ~signatures[id]) != 0 || clauses[other].size() > clause.size())
+                            continue;
+
+                        auto result = check_subset(clauses[other]);
+                        if (result == 0) {
+                            subsumer = other;
+                            break;
+                        }
+                        if (result != not_subset && strengthen) {
+                            flipped = result;
+                            break;
+                        }
+                    }
+                    if (subsumer != UINT32_MAX || flipped != not_subset)
+                        break;
+                }
+                if (subsumer != UINT32_MAX || flipped != not_subset)
+                    break;
+            }
+            mark(clause, false);
+
+            if (subsumer != UINT32_MAX) {
+                sat_utils::invalidate_clause(clause);
+                subsumed++;
+                on_subsumed(id, subsumer);
+                return false;
+            }
+            if (flipped != not_subset) {
+                remove_literal(clause, id, negate(flipped));
+                changed = true;
+            }
+        }
+        return true;
+    }
+
+    // Checks the clauses containing the least frequent literal of a strengthened clause or its negation
+    template <typename Callback>
+    void check_backward(std::vector<std::vector<literal>>& clauses, uint32_t id, Callback& on_subsumed) {
+        const auto& clause = clauses[id];
+        if (sat_utils::is_invalidated(clause) || clause.empty())
+            return;
+
+        auto lit = least_frequent(clause);
+        for (auto watched: {lit, negate(lit)}) {
+            for (auto other: occurrences[watched]) {
+                ticks++;
+                auto& candidate = clauses[other];
+                if (other == id || sat_utils::is_invalidated(candidate) || candidate.size() < clause.size()
+                    || (signatures[id] & ~signatures[other]) != 0)
+                    continue;
+
+                mark(candidate, true);
+                auto result = check_subset(clause);
+                mark(candidate, false);
+                if (result == 0) {
+                    sat_utils::invalidate_clause(candidate);
+                    subsumed++;
+                    on_subsumed(other, id);
+                } else if (result != not_subset) {
+                    remove_literal(candidate, other, negate(result));
+                }
+            }
+        }
+    }
+};
+
+#endif //SATSOLVER_SUBSUMPTION_H
@@ -0,0 +1,111 @@
+#ifndef SATSOLVER_THREAD_POOL_H
+#define SATSOLVER_THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+// Fixed set of workers running the tasks of one job at a time, the calling thread works on the job too.
+// Tasks are taken by whichever thread is free, so callers keep results per task and merge them in the order
+// of tasks, which makes the outcome independent of the timing of threads.
+class thread_pool {
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable job_ready;
+    std::condition_variable job_done;
+    std::function<void(uint32_t)> job;
+    uint32_t task_count;
+    uint32_t next_task;
+    uint32_t finished_tasks;
+    // incremented with every job, so a worker takes part in each job once
+    uint64_t generation;
+    bool stopping;
+
+public:
+    explicit thread_pool(uint32_t threads) : task_count(0), next_task(0), finished_tasks(0), generation(0),
+                                             stopping(false) {
+        for (uint32_t i = 1; i < threads; i++) {
+            workers.emplace_back([this] { work(); });
+        }
+    }
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        job_ready.notify_all();
+        for (auto& worker: workers) {
+            worker.join();
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    uint32_t size() const {
+        return workers.size() + 1;
+    }
+
+    // Runs task(0), ..., task(tasks - 1) and waits for all of them
+    template <typename Task>
+    void run(uint32_t tasks, Task task) {
+        if (workers.empty()) {
+            for (uint32_t i = 0; i < tasks; i++) {
+                task(i);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = task;
+            task_count = tasks;
+            next_task = 0;
+            finished_tasks = 0;
+            generation++;
+        }
+        job_ready.notify_all();
+        run_tasks();
+        std::unique_lock<std::mutex> lock(mutex);
+        job_done.wait(lock, [this] { return finished_tasks == task_count; });
+    }
+
+private:
+    void run_tasks() {
+        while (true) {
+            uint32_t task;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (next_task == task_count)
+                    return;
+
+                task = next_task++;
+            }
+            job(task);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (++finished_tasks == task_count)
+                job_done.notify_all();
+        }
+    }
+
+    void work() {
+        uint64_t seen_generation = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                job_ready.wait(lock, [&] { return stopping || generation != seen_generation; });
+                if (stopping)
+                    return;
+
+                seen_generation = generation;
+            }
+            run_tasks();
+        }
+    }
+};
+
+#endif //SATSOLVER_THREAD_POOL_H
@@ -0,0 +1,62 @@
+#ifndef SATSOLVER_UNASSIGNED_SET_H
+#define SATSOLVER_UNASSIGNED_SET_H
+
+#include "debug.h"
+#include "fast_random.h"
+#include <vector>
+
+// Set of variables with O(1) insert, remove and uniform sampling: variables are stored densely,
+// removal moves the last variable into the freed slot
+class unassigned_set {
+    std::vector<int> vars;
+    // position of a variable in vars, -1 if the variable is not in the set
+    std::vector<int> positions;
+
+public:
+    void init(int nb_vars) {
+        vars.clear();
+        vars.reserve(nb_vars);
+        positions.assign(nb_vars + 1, -1);
+        for (auto var = 1; var <= nb_vars; var++) {
+            positions[var] = vars.size();
+            vars.push_back(var);
+        }
+    }
+
+    size_t size() const {
+        return vars.size();
+    }
+
+    bool contains(int var) const {
+        return positions[var] >= 0;
+    }
+
+    void insert(int var) {
+        debug(if (contains(var))
+            debug_logic_error("Insert duplicate variable: " << var))
+
+        positions[var] = vars.size();
+        vars.push_back(var);
+    }
+
+    void remove(int var) {
+        debug(if (!contains(var))
+            debug_logic_error("Remove missing variable: " << var))
+
+        auto position = positions[var];
+        auto moved = vars.back();
+        vars[position] = moved;
+        positions[moved] = position;
+        vars.pop_back();
+        positions[var] = -1;
+    }
+
+    int pick_random(fast_random& random) const {
+        debug(if (vars.empty())
+            debug_logic_error("Random pick from empty set"))
+
+        return vars[random.next_int(vars.size())];
+    }
+};
+
+#endif //SATSOLVER_UNASSIGNED_SET_H
@@ -0,0 +1,120 @@
+#ifndef SATSOLVER_VMTF_PICKER_H
+#define SATSOLVER_VMTF_PICKER_H
+
+#include "debug.h"
+#include "solver_types.h"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// Variable move-to-front [8]: variables are kept in a queue ordered by the time of their last bump,
+// decisions are made on the most recently bumped unassigned variable
+template <typename Solver>
+class vmtf_picker {
+    const Solver& solver;
+    // doubly linked queue, 0 is the end of the queue in both directions
+    std::vector<int> prev;
+    std::vector<int> next;
+    std::vector<uint64_t> stamps;
+    int first;
+    int last;
+    // all variables after the search position are assigned
+    int search;
+    uint64_t current_stamp;
+    // variables bumped in the last conflict, moved to the front in the order of their stamps
+    std::vector<int> bumped;
+
+public:
+    vmtf_picker(const Solver& solver) : solver(solver) {}
+
+    void init() {
+        prev.assign(solver.nb_vars + 1, 0);
+        next.assign(solver.nb_vars + 1, 0);
+        stamps.assign(solver.nb_vars + 1, 0);
+        first = 0;
+        last = 0;
+        current_stamp = 0;
+        bumped.clear();
+        for (auto var = 1; var <= solver.nb_vars; var++) {
+            enqueue(var);
+        }
+        search = last;
+    }
+
+    void bump(int var) {
+        bumped.push_back(var);
+    }
+
+    void on_conflict() {}
+
+    void on_var_assign(int var) {}
+
+    void on_var_unset(int var) {
+        flush_bumped();
+        if (stamps[var] > stamps[search])
+            search = var;
+    }
+
+    // checks if the first variable would be picked before the second one
+    bool prefers(int a, int b) {
+        flush_bumped();
+        return stamps[a] > stamps[b];
+    }
+
+    int pick() {
+        flush_bumped();
+        auto var = search;
+        while (solver.values[make_literal(var, false)] != UNDEF) {
+            var = prev[var];
+            debug(if (var == 0)
+                debug_logic_error("VMTF queue has no unassigned variables"))
+        }
+        search = var;
+        return var;
+    }
+
+private:
+    // keeps the relative order of bumped variables, otherwise it would follow the order of conflict analysis
+    void flush_bumped() {
+        if (bumped.empty())
+            return;
+
+        std::sort(bumped.begin(), bumped.end(), [this](int a, int b) { return stamps[a] < stamps[b]; });
+        for (auto var: bumped) {
+            if (var != last) {
+                dequeue(var);
+                enqueue(var);
+            }
+            if (solver.values[make_literal(var, false)] == UNDEF)
+                search = var;
+        }
+        bumped.clear();
+    }
+
+    void enqueue(int var) {
+        prev[var] = last;
+        next[var] = 0;
+        if (last != 0) {
+            next[last] = var;
+        } else {
+            first = var;
+        }
+        last = var;
+        stamps[var] = ++current_stamp;
+    }
+
+    void dequeue(int var) {
+        if (prev[var] != 0) {
+            next[prev[var]] = next[var];
+        } else {
+            first = next[var];
+        }
+        if (next[var] != 0) {
+            prev[next[var]] = prev[var];
+        } else {
+            last = prev[var];
+        }
+    }
+};
+
+#endif //SATSOLVER_VMTF_PICKER_H
@@ -7,11 +7,12 @@
 #include <set>
 #include <cmath>
 
-class vsids_compare {
+// Orders variables by descending score, so the best one is the minimum of a heap
+class score_compare {
     const std::vector<double>& score;
 
 public:
-    vsids_compare(const std::vector<double>& score) : score(score) {}
+    score_compare(const std::vector<double>& score) : score(score) {}
 
     bool operator()(int a, int b) {
         if (score[a] != score[b])
@@ -24,22 +25,27 @@ template <typename Solver>
 class vsids_picker {
     const Solver& solver;
     std::vector<double> vsids_score;
-    min_heap<int, vsids_compare> vsids_queue;
+    min_heap<int, score_compare> vsids_queue;
     std::vector<int> vars_vector;
     uint32_t restart_count;
     double current_bump_value;
 
 public:
-    vsids_picker(const Solver& solver) : solver(solver), vsids_queue(vsids_compare(vsids_score)) {}
+    vsids_picker(const Solver& solver) : solver(solver), vsids_queue(score_compare(vsids_score)) {}
 
     void init() {
         restart_count = 0;
         current_bump_value = 1.0;
         vsids_score.clear();
         vsids_score.resize(solver.nb_vars + 1);
-        for (const auto& clause: solver.clauses) {
-            for (auto signed_var: clause) {
-                vsids_score[abs(signed_var)] += current_bump_value;
+        for (auto cref: solver.original_clauses) {
+            for (auto lit: solver.clauses[cref]) {
+                vsids_score[var_of(lit)] += current_bump_value;
+            }
+        }
+        for (const auto& implied: solver.implications) {
+            for (auto lit: implied) {
+                vsids_score[var_of(lit)] += current_bump_value;
             }
         }
         vars_vector.clear();
@@ -50,7 +56,7 @@ public:
         vsids_queue.rebuild_heap(vars_vector);
     }
 
-    void bump_variable(int var) {
+    void bump(int var) {
         vsids_score[var] += current_bump_value;
         vsids_queue.decrease(var);
     }
@@ -72,14 +78,23 @@ public:
         }
     }
 
+    void on_var_assign(int var) {}
+
     void on_var_unset(int var) {
         if (!vsids_queue.in_heap(var))
             vsids_queue.insert(var);
     }
 
+    // checks if the first variable would be picked before the second one
+    bool prefers(int a, int b) const {
+        if (vsids_score[a] != vsids_score[b])
+            return vsids_score[a] > vsids_score[b];
+        return a < b;
+    }
+
     int pick() {
         auto var = vsids_queue.min();
-        while (solver.values[var] != UNDEF) {
+        while (solver.values[make_literal(var, false)] != UNDEF) {
             vsids_queue.extract_min();
             var = vsids_queue.min();
         }
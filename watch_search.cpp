@@ -0,0 +1,59 @@
+#include "watch_search.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SATSOLVER_X86
+#include <immintrin.h>
+#endif
+
+namespace watch_search {
+    uint32_t find_non_false_scalar(const value_state* values, const literal* literals, uint32_t begin, uint32_t end) {
+        for (auto i = begin; i < end; i++) {
+            if (values[literals[i]] != FALSE)
+                return i;
+        }
+        return end;
+    }
+
+#ifdef SATSOLVER_X86
+    // Gathers values of 8 literals at once: every lane loads 4 bytes starting at the value of its literal,
+    // the lowest byte is the value itself
+    __attribute__((target("avx2")))
+    uint32_t find_non_false_avx2(const value_state* values, const literal* literals, uint32_t begin, uint32_t end) {
+        auto base = reinterpret_cast<const int*>(values);
+        auto byte_mask = _mm256_set1_epi32(0xFF);
+        auto false_value = _mm256_set1_epi32(FALSE);
+        auto i = begin;
+        for (; i + 8 <= end; i += 8) {
+            auto indices = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(literals + i));
+            auto gathered = _mm256_and_si256(_mm256_i32gather_epi32(base, indices, 1), byte_mask);
+            auto is_false = _mm256_cmpeq_epi32(gathered, false_value);
+            auto non_false = ~_mm256_movemask_ps(_mm256_castsi256_ps(is_false)) & 0xFF;
+            if (non_false != 0)
+                return i + __builtin_ctz(non_false);
+        }
+        return find_non_false_scalar(values, literals, i, end);
+    }
+
+    bool avx2_supported() {
+        return __builtin_cpu_supports("avx2");
+    }
+#else
+    uint32_t find_non_false_avx2(const value_state* values, const literal* literals, uint32_t begin, uint32_t end) {
+        return find_non_false_scalar(values, literals, begin, end);
+    }
+
+    bool avx2_supported() {
+        return false;
+    }
+#endif
+
+    watch_search_fn select(watch_search_mode mode) {
+        if (mode != watch_search_mode::SCALAR && avx2_supported())
+            return find_non_false_avx2;
+        return find_non_false_scalar;
+    }
+
+    const char* selected_name(watch_search_mode mode) {
+        return select(mode) == find_non_false_avx2 ? "avx2" : "scalar";
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef SATSOLVER_WATCH_SEARCH_H
+#define SATSOLVER_WATCH_SEARCH_H
+
+#include "solver_types.h"
+#include "solver_options.h"
+#include <cstdint>
+
+// Finds the first literal in [begin, end) whose value is not FALSE, returns end if there is none.
+// Values are indexed by literal and must be readable 3 bytes past the last literal.
+typedef uint32_t (*watch_search_fn)(const value_state* values, const literal* literals, uint32_t begin, uint32_t end);
+
+namespace watch_search {
+    // extra bytes after the value array, the AVX2 kernel reads every value as a 32-bit word
+    static constexpr size_t value_padding = 3;
+
+    uint32_t find_non_false_scalar(const value_state* values, const literal* literals, uint32_t begin, uint32_t end);
+    uint32_t find_non_false_avx2(const value_state* values, const literal* literals, uint32_t begin, uint32_t end);
+
+    bool avx2_supported();
+    // AUTO resolves to AVX2 if the CPU supports it, AVX2 falls back to the scalar kernel otherwise
+    watch_search_fn select(watch_search_mode mode);
+    const char* selected_name(watch_search_mode mode);
+}
+
+#endif //SATSOLVER_WATCH_SEARCH_H